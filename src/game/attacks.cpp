@@ -0,0 +1,281 @@
+#include "game/attacks.hpp"
+
+#include "common/utils.hpp"
+
+#include <array>
+#include <cstdlib>
+#include <span>
+#include <vector>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define CHESSFML_HAS_PEXT_BACKEND 1
+#include <immintrin.h>
+#else
+#define CHESSFML_HAS_PEXT_BACKEND 0
+#endif
+
+namespace {
+
+using chessfml::bitboard_t;
+using chessfml::move_t;
+
+constexpr std::array<std::pair<int, int>, 4> rook_directions = {{{-1, 0}, {0, -1}, {0, 1}, {1, 0}}};
+
+constexpr std::array<std::pair<int, int>, 4> bishop_directions = {{{-1, -1}, {-1, 1}, {1, -1}, {1, 1}}};
+
+// Reference ray walk, only used to fill the tables
+bitboard_t sliding_attacks(move_t pos, bitboard_t occupancy, std::span<const std::pair<int, int>> directions)
+{
+    using namespace chessfml;
+
+    bitboard_t attacks = bitboard::empty;
+    const auto [rank, file] = position_to_rank_file(pos);
+
+    constexpr int board_size = config::board::size;
+
+    for (const auto& [dr, df] : directions) {
+        for (int i = 1; i < board_size; ++i) {
+            const int new_rank = rank + dr * i;
+            const int new_file = file + df * i;
+
+            if (new_rank < 0 || new_rank >= board_size || new_file < 0 || new_file >= board_size) {
+                break;
+            }
+
+            const move_t new_pos = rank_file_to_position(new_rank, new_file);
+            attacks |= bitboard::square(new_pos);
+
+            if (bitboard::test(occupancy, new_pos)) {
+                break;  // The blocker is attacked, nothing behind it is
+            }
+        }
+    }
+
+    return attacks;
+}
+
+// Squares whose occupancy can change the attack set: the rays without their last square
+bitboard_t relevant_mask(move_t pos, std::span<const std::pair<int, int>> directions)
+{
+    using namespace chessfml;
+
+    bitboard_t mask = bitboard::empty;
+    const auto [rank, file] = position_to_rank_file(pos);
+
+    constexpr int board_size = config::board::size;
+
+    for (const auto& [dr, df] : directions) {
+        for (int i = 1; i < board_size; ++i) {
+            const int next_rank = rank + dr * (i + 1);
+            const int next_file = file + df * (i + 1);
+
+            if (next_rank < 0 || next_rank >= board_size || next_file < 0 || next_file >= board_size) {
+                break;
+            }
+
+            mask |= bitboard::square(rank_file_to_position(rank + dr * i, file + df * i));
+        }
+    }
+
+    return mask;
+}
+
+// Fixed-seed xorshift so the magics found are identical on every run
+class magic_rng
+{
+public:
+    bitboard_t next() noexcept
+    {
+        m_state ^= m_state >> 12;
+        m_state ^= m_state << 25;
+        m_state ^= m_state >> 27;
+        return m_state * 0x2545F4914F6CDD1DULL;
+    }
+
+    // Few set bits make good magic candidates
+    bitboard_t sparse() noexcept { return next() & next() & next(); }
+
+private:
+    bitboard_t m_state{0x9E3779B97F4A7C15ULL};
+};
+
+// Portable equivalent of _pext_u64, only used to lay out the PEXT table
+std::size_t software_pext(bitboard_t value, bitboard_t mask) noexcept
+{
+    std::size_t result = 0;
+    for (std::size_t bit = 1; mask != chessfml::bitboard::empty; mask &= mask - 1, bit <<= 1) {
+        if ((value & mask & -mask) != chessfml::bitboard::empty) {
+            result |= bit;
+        }
+    }
+    return result;
+}
+
+// BMI2 is checked once through cpuid. Zen 1/2 report BMI2 but run PEXT in microcode, slower than a multiply,
+// so they stay on the magic path. CHESSFML_NO_PEXT forces the magic path to compare both backends on one machine
+bool detect_pext() noexcept
+{
+#if CHESSFML_HAS_PEXT_BACKEND
+    __builtin_cpu_init();
+    if (!__builtin_cpu_supports("bmi2") || __builtin_cpu_is("znver1") || __builtin_cpu_is("znver2")) {
+        return false;
+    }
+    return std::getenv("CHESSFML_NO_PEXT") == nullptr;
+#else
+    return false;
+#endif
+}
+
+// Asked on first use rather than during static initialization, so it never depends on the order across TUs
+bool pext_enabled() noexcept
+{
+    static const bool enabled = detect_pext();
+    return enabled;
+}
+
+struct magic_entry
+{
+    bitboard_t        mask;
+    bitboard_t        magic;
+    const bitboard_t* attacks;
+    const bitboard_t* pext_attacks;  // Same attack sets ordered by PEXT index, null when the backend is off
+    unsigned          shift;
+
+    std::size_t index(bitboard_t occupancy) const noexcept { return ((occupancy & mask) * magic) >> shift; }
+};
+
+#if CHESSFML_HAS_PEXT_BACKEND
+__attribute__((target("bmi2"))) bitboard_t pext_lookup(const magic_entry& entry, bitboard_t occupancy) noexcept
+{
+    return entry.pext_attacks[_pext_u64(occupancy, entry.mask)];
+}
+#endif
+
+class magic_table
+{
+public:
+    magic_table(std::span<const std::pair<int, int>> directions, bool with_pext)
+    {
+        using namespace chessfml;
+
+        std::array<std::size_t, 64> offsets{};
+        std::size_t                 total_size = 0;
+
+        for (move_t pos = 0; pos < m_entries.size(); ++pos) {
+            m_entries[pos].mask = relevant_mask(pos, directions);
+            m_entries[pos].shift = 64 - bitboard::count(m_entries[pos].mask);
+            offsets[pos] = total_size;
+            total_size += std::size_t{1} << bitboard::count(m_entries[pos].mask);
+        }
+
+        m_attacks.resize(total_size);
+        if (with_pext) {
+            m_pext_attacks.resize(total_size);
+        }
+
+        magic_rng                rng;
+        std::vector<bitboard_t>  occupancies;
+        std::vector<bitboard_t>  references;
+        std::vector<std::size_t> used_by;
+
+        for (move_t pos = 0; pos < m_entries.size(); ++pos) {
+            auto& entry = m_entries[pos];
+            entry.attacks = m_attacks.data() + offsets[pos];
+
+            // Enumerate every subset of the mask (Carry-Rippler)
+            occupancies.clear();
+            references.clear();
+            bitboard_t subset = bitboard::empty;
+            do {
+                occupancies.push_back(subset);
+                references.push_back(sliding_attacks(pos, subset, directions));
+                subset = (subset - entry.mask) & entry.mask;
+            } while (subset != bitboard::empty);
+
+            const std::span<bitboard_t> slots{m_attacks.data() + offsets[pos], occupancies.size()};
+            used_by.assign(occupancies.size(), 0);
+
+            // Try candidates until one maps every subset without a destructive collision. used_by stores the
+            // attempt number that last wrote each slot, so slots never need clearing between attempts
+            for (std::size_t attempt = 1;; ++attempt) {
+                entry.magic = rng.sparse();
+                if (bitboard::count((entry.mask * entry.magic) >> 56) < 6) {
+                    continue;
+                }
+
+                bool found = true;
+                for (std::size_t i = 0; i < occupancies.size() && found; ++i) {
+                    const auto idx = entry.index(occupancies[i]);
+                    if (used_by[idx] != attempt) {
+                        used_by[idx] = attempt;
+                        slots[idx] = references[i];
+                    } else if (slots[idx] != references[i]) {
+                        found = false;
+                    }
+                }
+
+                if (found) {
+                    break;
+                }
+            }
+
+            if (with_pext) {
+                entry.pext_attacks = m_pext_attacks.data() + offsets[pos];
+                for (std::size_t i = 0; i < occupancies.size(); ++i) {
+                    m_pext_attacks[offsets[pos] + software_pext(occupancies[i], entry.mask)] = references[i];
+                }
+            }
+        }
+    }
+
+    bitboard_t attacks(move_t pos, bitboard_t occupancy) const noexcept
+    {
+        const auto& entry = m_entries[pos];
+#if CHESSFML_HAS_PEXT_BACKEND
+        if (entry.pext_attacks != nullptr) {
+            return pext_lookup(entry, occupancy);
+        }
+#endif
+        return entry.attacks[entry.index(occupancy)];
+    }
+
+private:
+    std::array<magic_entry, 64> m_entries{};
+    std::vector<bitboard_t>     m_attacks;
+    std::vector<bitboard_t>     m_pext_attacks;
+};
+
+// Built on the first lookup. A namespace-scope table would be filled during dynamic initialization, and a caller
+// from another TU's static initializer, say a board set up from a FEN, could read it still empty
+const magic_table& rook_table() noexcept
+{
+    static const magic_table table{rook_directions, pext_enabled()};
+    return table;
+}
+
+const magic_table& bishop_table() noexcept
+{
+    static const magic_table table{bishop_directions, pext_enabled()};
+    return table;
+}
+
+}  // anonymous namespace
+
+namespace chessfml::attacks {
+
+bitboard_t rook_attacks(move_t pos, bitboard_t occupancy) noexcept
+{
+    return rook_table().attacks(pos, occupancy);
+}
+
+bitboard_t bishop_attacks(move_t pos, bitboard_t occupancy) noexcept
+{
+    return bishop_table().attacks(pos, occupancy);
+}
+
+backend active_backend() noexcept
+{
+    return pext_enabled() ? backend::Pext : backend::Magic;
+}
+
+}  // namespace chessfml::attacks
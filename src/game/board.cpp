@@ -1,11 +1,82 @@
 #include "game/board.hpp"
 
 #include "common/config.hpp"
+#include "game/attacks.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <print>
+
+// Set by the CHESSFML_CHECK_ZOBRIST CMake option
+#ifndef CHESSFML_CHECK_ZOBRIST
+#define CHESSFML_CHECK_ZOBRIST 0
+#endif
 
 namespace chessfml {
 
+namespace {
+
+// Moving from or capturing on a king or rook home square removes the matching castling rights
+void update_castling_rights(game_state& state, move_t pos) noexcept
+{
+    using player = game_state::player_turn;
+
+    switch (pos) {
+        case 60:  // e1
+            state.disable_kingside_castling(player::White);
+            state.disable_queenside_castling(player::White);
+            break;
+        case 63:  // h1
+            state.disable_kingside_castling(player::White);
+            break;
+        case 56:  // a1
+            state.disable_queenside_castling(player::White);
+            break;
+        case 4:  // e8
+            state.disable_kingside_castling(player::Black);
+            state.disable_queenside_castling(player::Black);
+            break;
+        case 7:  // h8
+            state.disable_kingside_castling(player::Black);
+            break;
+        case 0:  // a8
+            state.disable_queenside_castling(player::Black);
+            break;
+        default:
+            break;
+    }
+}
+
+// The castling rook starts in the corner on the king's side and lands on the square the king crossed
+std::pair<move_t, move_t> castling_rook_squares(const move_info& move) noexcept
+{
+    const bool is_kingside = move.to > move.from;
+    if (is_kingside) {
+        return {static_cast<move_t>(move.from + 3), static_cast<move_t>(move.from + 1)};
+    }
+    return {static_cast<move_t>(move.from - 4), static_cast<move_t>(move.from - 1)};
+}
+
+// Compares the incrementally updated key with a full recompute, aborting on the first mismatch
+void check_key([[maybe_unused]] const board_t& board, [[maybe_unused]] const game_state& state) noexcept
+{
+    if constexpr (CHESSFML_CHECK_ZOBRIST) {
+        if (position_key(board, state) != zobrist::compute(board, state)) {
+            std::println(stderr,
+                         "Zobrist key mismatch: {:016x} != {:016x}",
+                         position_key(board, state),
+                         zobrist::compute(board, state));
+            std::abort();
+        }
+    }
+}
+
+}  // namespace
+
 std::expected<std::string_view, fen_error> board_t::fen_to_board(std::string_view fen)
 {
+    clear();
+
     std::uint8_t index{0u};
     for (const auto c : fen) {
         if (index >= 64) {
@@ -26,7 +97,6 @@ std::expected<std::string_view, fen_error> board_t::fen_to_board(std::string_vie
             while (empty_squares-- > 0) {
                 if (index >= 64)
                     return std::unexpected(fen_error::InvalidFormat);
-                m_board[index] = piece_t{piece_t::type_t::Empty, index};
                 index++;
             }
         } else {
@@ -35,26 +105,27 @@ std::expected<std::string_view, fen_error> board_t::fen_to_board(std::string_vie
 
             switch (piece_char) {
                 case 'P':
-                    m_board[index] = piece_t{piece_t::type_t::Pawn, index, pc};
+                    set_piece(index, piece_t{piece_t::type_t::Pawn, pc});
                     break;
                 case 'R':
-                    m_board[index] = piece_t{piece_t::type_t::Rook, index, pc};
+                    set_piece(index, piece_t{piece_t::type_t::Rook, pc});
                     break;
                 case 'N':
-                    m_board[index] = piece_t{piece_t::type_t::Knight, index, pc};
+                    set_piece(index, piece_t{piece_t::type_t::Knight, pc});
                     break;
                 case 'B':
-                    m_board[index] = piece_t{piece_t::type_t::Bishop, index, pc};
+                    set_piece(index, piece_t{piece_t::type_t::Bishop, pc});
                     break;
                 case 'Q':
-                    m_board[index] = piece_t{piece_t::type_t::Queen, index, pc};
+                    set_piece(index, piece_t{piece_t::type_t::Queen, pc});
                     break;
                 case 'K':
-                    m_board[index] = piece_t{piece_t::type_t::King, index, pc};
+                    set_piece(index, piece_t{piece_t::type_t::King, pc});
                     break;
                 default:
-                    m_board[index] = piece_t{piece_t::type_t::Empty, index, pc};
+                    // Unknown pieces leave the square empty
                     // return std::unexpected(fen_error::InvalidCharacter);
+                    break;
             }
             ++index;
         }
@@ -79,6 +150,230 @@ void board_t::set_board_fen(std::string_view fen)
     }
 }
 
+void board_t::set_piece(move_t pos, piece_t piece) noexcept
+{
+    remove_piece(pos);
+
+    if (piece.get_type() == piece_t::type_t::Empty) {
+        return;
+    }
+
+    // Sliders seeing the square lose the part of their rays behind the new piece
+    const auto sliders = m_track_attacks ? sliders_through(pos) : bitboard::empty;
+    if (m_track_attacks) {
+        update_attacks(sliders, -1);
+    }
+
+    const auto bb = bitboard::square(pos);
+    m_type_bb[std::to_underlying(piece.get_type())] |= bb;
+    m_color_bb[std::to_underlying(piece.get_color())] |= bb;
+
+    if (piece.get_type() == piece_t::type_t::King) {
+        m_king_pos[std::to_underlying(piece.get_color())] = pos;
+    }
+
+    m_key ^= zobrist::piece_key(piece.get_color(), piece.get_type(), pos);
+
+    m_board[pos] = piece;
+
+    if (m_track_attacks) {
+        update_attacks(sliders | bb, 1);
+    }
+}
+
+void board_t::remove_piece(move_t pos) noexcept
+{
+    const auto& piece = m_board[pos];
+    if (piece.get_type() == piece_t::type_t::Empty) {
+        return;
+    }
+
+    // The piece takes its attacks with it, and sliders seeing the square extend their rays past it
+    const auto bb = bitboard::square(pos);
+    const auto sliders = m_track_attacks ? sliders_through(pos) : bitboard::empty;
+    if (m_track_attacks) {
+        update_attacks(sliders | bb, -1);
+    }
+
+    m_type_bb[std::to_underlying(piece.get_type())] &= ~bb;
+    m_color_bb[std::to_underlying(piece.get_color())] &= ~bb;
+
+    if (piece.get_type() == piece_t::type_t::King) {
+        m_king_pos[std::to_underlying(piece.get_color())] = no_square;
+    }
+
+    m_key ^= zobrist::piece_key(piece.get_color(), piece.get_type(), pos);
+
+    m_board[pos] = piece_t{};
+
+    if (m_track_attacks) {
+        update_attacks(sliders, 1);
+    }
+}
+
+void board_t::move_piece(move_t from, move_t to) noexcept
+{
+    piece_t piece = m_board[from];
+    remove_piece(from);
+    set_piece(to, piece);
+}
+
+void board_t::clear() noexcept
+{
+    m_board.fill(piece_t{});
+
+    m_type_bb.fill(bitboard::empty);
+    m_color_bb.fill(bitboard::empty);
+    m_king_pos.fill(no_square);
+    m_key = 0;
+
+    for (auto& counts : m_attack_counts) {
+        counts.fill(0);
+    }
+    m_attacked.fill(bitboard::empty);
+}
+
+void board_t::set_attack_tracking(bool enabled) noexcept
+{
+    m_track_attacks = enabled;
+
+    for (auto& counts : m_attack_counts) {
+        counts.fill(0);
+    }
+    m_attacked.fill(bitboard::empty);
+
+    if (enabled) {
+        update_attacks(occupancy(), 1);
+    }
+}
+
+bitboard_t board_t::piece_attacks(move_t pos) const noexcept
+{
+    const auto& piece = m_board[pos];
+
+    switch (piece.get_type()) {
+        case piece_t::type_t::Pawn:
+            return attacks::pawn_attacks(piece.get_color(), pos);
+        case piece_t::type_t::Knight:
+            return attacks::knight_attacks(pos);
+        case piece_t::type_t::Bishop:
+            return attacks::bishop_attacks(pos, occupancy());
+        case piece_t::type_t::Rook:
+            return attacks::rook_attacks(pos, occupancy());
+        case piece_t::type_t::Queen:
+            return attacks::queen_attacks(pos, occupancy());
+        case piece_t::type_t::King:
+            return attacks::king_attacks(pos);
+        default:
+            return bitboard::empty;
+    }
+}
+
+// Sliders of both colors whose rays reach 'pos', i.e. those whose attack sets change when it is filled or emptied
+bitboard_t board_t::sliders_through(move_t pos) const noexcept
+{
+    const auto queens = pieces(piece_t::type_t::Queen);
+    return (attacks::rook_attacks(pos, occupancy()) & (pieces(piece_t::type_t::Rook) | queens)) |
+           (attacks::bishop_attacks(pos, occupancy()) & (pieces(piece_t::type_t::Bishop) | queens));
+}
+
+// Adds (delta = 1) or removes (delta = -1) the current attack sets of 'pieces' from the attack maps
+void board_t::update_attacks(bitboard_t pieces, int delta) noexcept
+{
+    while (pieces != bitboard::empty) {
+        const auto pos = bitboard::pop_lsb(pieces);
+        const auto color = std::to_underlying(m_board[pos].get_color());
+
+        for (auto targets = piece_attacks(pos); targets != bitboard::empty;) {
+            const auto target = bitboard::pop_lsb(targets);
+            auto&      count = m_attack_counts[color][target];
+
+            count = static_cast<std::uint8_t>(count + delta);
+            if (count == 0) {
+                m_attacked[color] &= ~bitboard::square(target);
+            } else {
+                m_attacked[color] |= bitboard::square(target);
+            }
+        }
+    }
+}
+
+undo_info board_t::make_move(const move_info& move, game_state& state) noexcept
+{
+    piece_t piece = m_board[move.from];
+
+    undo_info undo{.move = move,
+                   .moved = piece,
+                   .captured = m_board[move.to],
+                   .captured_pos = move.to,
+                   .castling_rights = state.get_castling_rights(),
+                   .en_passant_target = state.get_en_passant_target(),
+                   .halfmove_clock = state.get_halfmove_clock(),
+                   .fullmove_number = state.get_fullmove_number(),
+                   .in_check = state.is_check()};
+
+    if (move.is_en_passant()) {
+        // The captured pawn sits behind the target square, from the mover's point of view
+        undo.captured_pos = piece.get_color() == piece_t::color_t::White ? move.to + 8 : move.to - 8;
+        undo.captured = m_board[undo.captured_pos];
+        remove_piece(undo.captured_pos);
+    }
+
+    if (move.is_castling()) {
+        const auto [rook_from, rook_to] = castling_rook_squares(move);
+        move_piece(rook_from, rook_to);
+    }
+
+    if (move.is_promotion()) {
+        piece.set_type(static_cast<piece_t::type_t>(move.promotion_piece));
+    }
+
+    remove_piece(move.from);
+    set_piece(move.to, piece);
+
+    update_castling_rights(state, move.from);
+    update_castling_rights(state, move.to);
+
+    const bool is_pawn_move = undo.moved.get_type() == piece_t::type_t::Pawn;
+    if (is_pawn_move && (move.to == move.from + 16 || move.from == move.to + 16)) {
+        state.set_en_passant_target((move.from + move.to) / 2);
+    } else {
+        state.set_en_passant_target(std::nullopt);
+    }
+
+    state.update_move_counters(is_pawn_move || undo.captured.get_type() != piece_t::type_t::Empty);
+    state.next_turn();
+
+    check_key(*this, state);
+    return undo;
+}
+
+void board_t::unmake_move(const undo_info& undo, game_state& state) noexcept
+{
+    const auto& move = undo.move;
+
+    remove_piece(move.to);
+    set_piece(move.from, undo.moved);
+
+    if (move.is_castling()) {
+        const auto [rook_from, rook_to] = castling_rook_squares(move);
+        move_piece(rook_to, rook_from);
+    }
+
+    if (undo.captured.get_type() != piece_t::type_t::Empty) {
+        set_piece(undo.captured_pos, undo.captured);
+    }
+
+    state.next_turn();
+    state.set_castling_rights(undo.castling_rights);
+    state.set_en_passant_target(undo.en_passant_target);
+    state.set_halfmove_clock(undo.halfmove_clock);
+    state.set_fullmove_number(undo.fullmove_number);
+    state.set_check(undo.in_check);
+
+    check_key(*this, state);
+}
+
 void board_t::print() const
 {
     auto row{0};
@@ -0,0 +1,148 @@
+#include "game/engine/evaluate.hpp"
+
+#include "common/bitboard.hpp"
+
+#include <utility>
+
+namespace {
+
+using chessfml::engine::score_t;
+using square_scores = std::array<score_t, 64>;
+
+// Bonuses for White, laid out like the board array (a8 first). Black reads them mirrored across the middle
+// rank. Values from the Simplified Evaluation Function by Tomasz Michniewski
+// clang-format off
+constexpr square_scores pawn_table = {
+     0,  0,   0,   0,   0,   0,  0,  0,
+    50, 50,  50,  50,  50,  50, 50, 50,
+    10, 10,  20,  30,  30,  20, 10, 10,
+     5,  5,  10,  25,  25,  10,  5,  5,
+     0,  0,   0,  20,  20,   0,  0,  0,
+     5, -5, -10,   0,   0, -10, -5,  5,
+     5, 10,  10, -20, -20,  10, 10,  5,
+     0,  0,   0,   0,   0,   0,  0,  0,
+};
+
+constexpr square_scores knight_table = {
+    -50, -40, -30, -30, -30, -30, -40, -50,
+    -40, -20,   0,   0,   0,   0, -20, -40,
+    -30,   0,  10,  15,  15,  10,   0, -30,
+    -30,   5,  15,  20,  20,  15,   5, -30,
+    -30,   0,  15,  20,  20,  15,   0, -30,
+    -30,   5,  10,  15,  15,  10,   5, -30,
+    -40, -20,   0,   5,   5,   0, -20, -40,
+    -50, -40, -30, -30, -30, -30, -40, -50,
+};
+
+constexpr square_scores bishop_table = {
+    -20, -10, -10, -10, -10, -10, -10, -20,
+    -10,   0,   0,   0,   0,   0,   0, -10,
+    -10,   0,   5,  10,  10,   5,   0, -10,
+    -10,   5,   5,  10,  10,   5,   5, -10,
+    -10,   0,  10,  10,  10,  10,   0, -10,
+    -10,  10,  10,  10,  10,  10,  10, -10,
+    -10,   5,   0,   0,   0,   0,   5, -10,
+    -20, -10, -10, -10, -10, -10, -10, -20,
+};
+
+constexpr square_scores rook_table = {
+     0,  0,  0,  0,  0,  0,  0,  0,
+     5, 10, 10, 10, 10, 10, 10,  5,
+    -5,  0,  0,  0,  0,  0,  0, -5,
+    -5,  0,  0,  0,  0,  0,  0, -5,
+    -5,  0,  0,  0,  0,  0,  0, -5,
+    -5,  0,  0,  0,  0,  0,  0, -5,
+    -5,  0,  0,  0,  0,  0,  0, -5,
+     0,  0,  0,  5,  5,  0,  0,  0,
+};
+
+constexpr square_scores queen_table = {
+    -20, -10, -10, -5, -5, -10, -10, -20,
+    -10,   0,   0,  0,  0,   0,   0, -10,
+    -10,   0,   5,  5,  5,   5,   0, -10,
+     -5,   0,   5,  5,  5,   5,   0,  -5,
+      0,   0,   5,  5,  5,   5,   0,  -5,
+    -10,   5,   5,  5,  5,   5,   0, -10,
+    -10,   0,   5,  0,  0,   0,   0, -10,
+    -20, -10, -10, -5, -5, -10, -10, -20,
+};
+
+// Behind the pawn shield while the queens and rooks are out, in the centre once they are gone
+constexpr square_scores king_middlegame_table = {
+    -30, -40, -40, -50, -50, -40, -40, -30,
+    -30, -40, -40, -50, -50, -40, -40, -30,
+    -30, -40, -40, -50, -50, -40, -40, -30,
+    -30, -40, -40, -50, -50, -40, -40, -30,
+    -20, -30, -30, -40, -40, -30, -30, -20,
+    -10, -20, -20, -20, -20, -20, -20, -10,
+     20,  20,   0,   0,   0,   0,  20,  20,
+     20,  30,  10,   0,   0,  10,  30,  20,
+};
+
+constexpr square_scores king_endgame_table = {
+    -50, -40, -30, -20, -20, -30, -40, -50,
+    -30, -20, -10,   0,   0, -10, -20, -30,
+    -30, -10,  20,  30,  30,  20, -10, -30,
+    -30, -10,  30,  40,  40,  30, -10, -30,
+    -30, -10,  30,  40,  40,  30, -10, -30,
+    -30, -10,  20,  30,  30,  20, -10, -30,
+    -30, -30,   0,   0,   0,   0, -30, -30,
+    -50, -30, -30, -30, -30, -30, -30, -50,
+};
+// clang-format on
+
+// Indexed by piece_t::type_t, the king is handled apart
+constexpr std::array<const square_scores*, 7> piece_tables = {
+    nullptr, &pawn_table, &rook_table, &knight_table, &bishop_table, &queen_table, nullptr};
+
+// Game phase weights of the non-pawn pieces: 24 with every piece on the board, 0 with bare kings and pawns
+constexpr std::array<int, 7> phase_weights = {0, 0, 2, 1, 1, 4, 0};
+constexpr int                full_phase = 24;
+
+// Flips the rank so Black reads the White tables
+constexpr chessfml::move_t relative_square(chessfml::piece_t::color_t color, chessfml::move_t square) noexcept
+{
+    return color == chessfml::piece_t::color_t::White ? square : square ^ 56;
+}
+
+}  // anonymous namespace
+
+namespace chessfml::engine {
+
+score_t evaluate(const board_t& board, piece_t::color_t side) noexcept
+{
+    score_t score = 0;
+    score_t king_middlegame = 0;
+    score_t king_endgame = 0;
+    int     phase = 0;
+
+    for (auto color : {piece_t::color_t::White, piece_t::color_t::Black}) {
+        const score_t sign = color == side ? 1 : -1;
+
+        for (auto type : {piece_t::type_t::Pawn,
+                          piece_t::type_t::Rook,
+                          piece_t::type_t::Knight,
+                          piece_t::type_t::Bishop,
+                          piece_t::type_t::Queen}) {
+            const auto  index = std::to_underlying(type);
+            const auto& table = *piece_tables[index];
+
+            for (auto pieces = board.pieces(type, color); pieces != bitboard::empty;) {
+                score += sign * (piece_values[index] + table[relative_square(color, bitboard::pop_lsb(pieces))]);
+                phase += phase_weights[index];
+            }
+        }
+
+        if (const auto king = board.king_square(color); king != board_t::no_square) {
+            king_middlegame += sign * king_middlegame_table[relative_square(color, king)];
+            king_endgame += sign * king_endgame_table[relative_square(color, king)];
+        }
+    }
+
+    // Early promotions can push the phase past the start value
+    phase = phase < full_phase ? phase : full_phase;
+
+    return score + (king_middlegame * phase + king_endgame * (full_phase - phase)) / full_phase;
+}
+
+}  // namespace chessfml::engine
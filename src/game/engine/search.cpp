@@ -0,0 +1,450 @@
+#include "game/engine/search.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <thread>
+#include <utility>
+
+namespace {
+
+using chessfml::move_info;
+using chessfml::engine::score_t;
+
+// Ordering scores, far enough apart that the groups never mix: the transposition table's move, the previous
+// iteration's move for this ply, then captures and promotions by MVV-LVA, then the killers, then the other quiet
+// moves
+constexpr int tt_move_order = 2'000'000;
+constexpr int pv_move_order = 1'000'000;
+constexpr int capture_order = 100'000;
+constexpr int killer_order = 90'000;
+
+// Nodes between two reads of the clock
+constexpr std::uint64_t time_check_interval = 1024;
+
+// move_info's operator== ignores the promotion piece, which tells apart four moves with the same squares
+bool same_move(const move_info& lhs, const move_info& rhs) noexcept
+{
+    return lhs.from == rhs.from && lhs.to == rhs.to && lhs.promotion_piece == rhs.promotion_piece;
+}
+
+// Mate scores are stored relative to the node rather than the root, so they stay right when the position is
+// reached again at another ply
+score_t score_to_tt(score_t score, int ply) noexcept
+{
+    if (!chessfml::engine::is_mate_score(score)) {
+        return score;
+    }
+    return score > 0 ? score + ply : score - ply;
+}
+
+score_t score_from_tt(score_t score, int ply) noexcept
+{
+    if (!chessfml::engine::is_mate_score(score)) {
+        return score;
+    }
+    return score > 0 ? score - ply : score + ply;
+}
+
+chessfml::piece_t::color_t side_to_move(const chessfml::game_state& state) noexcept
+{
+    return state.get_player_turn() == chessfml::game_state::player_turn::White ? chessfml::piece_t::color_t::White
+                                                                                : chessfml::piece_t::color_t::Black;
+}
+
+}  // anonymous namespace
+
+namespace chessfml::engine {
+
+search_result searcher::search(const board_t&       board,
+                               const game_state&    state,
+                               const key_history&   history,
+                               const search_limits& limits)
+{
+    m_tt.new_search();
+
+    // The clock and node count are the main thread's to keep, the helpers go as deep as allowed until it is done
+    const search_limits helper_limits{.depth = limits.depth};
+
+    search_result result;
+    {
+        std::vector<std::jthread> helpers;
+        helpers.reserve(m_workers.size() - 1);
+        for (std::size_t i = 1; i < m_workers.size(); ++i) {
+            helpers.emplace_back([&, i] { m_workers[i]->search(board, state, history, helper_limits); });
+        }
+
+        result = m_workers[0]->search(board, state, history, limits);
+
+        // The helpers notice within a node and are joined on leaving the scope
+        m_stop.store(true, std::memory_order_relaxed);
+    }
+
+    // Cleared only once everyone is done, so a stop() that comes before a search starts still ends it
+    m_stop.store(false, std::memory_order_relaxed);
+
+    result.nodes = 0;
+    for (const auto& worker : m_workers) {
+        result.nodes += worker->nodes();
+    }
+    return result;
+}
+
+void searcher::set_threads(std::size_t threads)
+{
+    m_workers.clear();
+    for (std::size_t i = 0; i < std::max<std::size_t>(threads, 1); ++i) {
+        m_workers.push_back(std::make_unique<search_worker>(static_cast<int>(i), m_tt, m_stop));
+    }
+}
+
+search_result search_worker::search(const board_t&       board,
+                                    const game_state&    state,
+                                    const key_history&   history,
+                                    const search_limits& limits)
+{
+    // The attack maps pay for themselves on the game board, not over millions of make/unmake pairs
+    m_board = board;
+    m_board.set_attack_tracking(false);
+    m_state = state;
+    m_history = history;
+    m_limits = limits;
+    m_time = time_manager{limits};
+
+    if (m_history.empty()) {
+        m_history.push(position_key(m_board, m_state));
+    }
+
+    m_undo.clear();
+    m_undo.reserve(max_ply);
+    m_nodes = 0;
+    m_has_searched_move = false;
+    m_aborted = false;
+    m_previous_pv.clear();
+    m_killers = {};
+
+    search_result result;
+
+    move_list root_moves;
+    move_generator::generate_all(m_board, m_state, root_moves);
+
+    if (root_moves.empty()) {
+        const bool in_check = move_generator::is_in_check(m_board, m_state.get_player_turn());
+        result.score = in_check ? -mate_score : draw_score;
+        return result;
+    }
+
+    // Something legal to play even if the first iteration is cut short
+    result.best_move = root_moves[0];
+
+    // Nothing to think about, and the time saved goes back on the clock
+    if (root_moves.size() == 1 && m_time.is_enabled()) {
+        result.pv = {root_moves[0]};
+        return result;
+    }
+
+    // Odd helpers start one ply deeper, so the threads spread over two depths at a time
+    for (int depth = 1 + m_index % 2; depth <= std::min(limits.depth, max_ply - 1); ++depth) {
+        const auto score = negamax(depth, 0, -infinite_score, infinite_score);
+        if (m_aborted) {
+            break;
+        }
+
+        result.best_move = m_pv[0][0];
+        result.score = score;
+        result.depth = depth;
+        result.pv.assign(m_pv[0].begin(), m_pv[0].begin() + m_pv_length[0]);
+        m_previous_pv = result.pv;
+        m_has_searched_move = true;
+
+        // A mate inside the horizon cannot be improved on by looking deeper
+        if (is_mate_score(score) && mate_score - std::abs(score) <= depth) {
+            break;
+        }
+
+        m_time.on_iteration(result.best_move.value());
+        if (m_time.should_stop_deepening()) {
+            break;
+        }
+    }
+
+    result.nodes = m_nodes;
+    return result;
+}
+
+score_t search_worker::negamax(int depth, int ply, score_t alpha, score_t beta)
+{
+    m_pv_length[ply] = ply;
+
+    if (should_stop()) {
+        return draw_score;
+    }
+
+    // The window the parent asked for. Mate-distance pruning narrows it to exactly the score of a mate delivered
+    // from here, which a table hit would then cut on before the mating move reached the line
+    const auto window_alpha = alpha;
+    const auto window_beta = beta;
+
+    if (ply > 0) {
+        // Any repetition is scored as a draw, the side ahead will have to find something else
+        if (m_state.is_fifty_move_draw() || m_history.repetitions(m_state.get_halfmove_clock()) > 0) {
+            return draw_score;
+        }
+
+        // No line from here can beat a mate already found closer to the root
+        alpha = std::max(alpha, -mate_score + ply);
+        beta = std::min(beta, mate_score - ply - 1);
+        if (alpha >= beta) {
+            return alpha;
+        }
+    }
+
+    // Checks are searched one ply deeper, so a forced sequence of them is not cut off at the horizon
+    const bool in_check = move_generator::is_in_check(m_board, m_state.get_player_turn());
+    if (in_check) {
+        ++depth;
+    }
+
+    if (depth <= 0) {
+        return quiescence(ply, alpha, beta);
+    }
+
+    ++m_nodes;
+
+    if (ply >= max_ply - 1) {
+        return evaluate(m_board, side_to_move(m_state));
+    }
+
+    const auto  key = position_key(m_board, m_state);
+    packed_move tt_move;
+
+    if (const auto hit = m_tt.probe(key)) {
+        tt_move = hit->move;
+
+        // The root always searches, it has to come back with a move and its line. A score inside the window
+        // would become part of the line, which the table does not keep, so only null-window nodes take that one
+        const auto score = score_from_tt(hit->score, ply);
+        const bool pv_node = window_beta - window_alpha > 1;
+        if (ply > 0 && hit->depth >= depth &&
+            ((hit->bound != bound_t::Upper && score >= window_beta) ||
+             (hit->bound != bound_t::Lower && score <= window_alpha) || (hit->bound == bound_t::Exact && !pv_node))) {
+            return score;
+        }
+    }
+
+    move_list moves;
+    move_generator::generate_all(m_board, m_state, moves);
+
+    if (moves.empty()) {
+        return in_check ? -mate_score + ply : draw_score;
+    }
+
+    std::array<int, move_list::capacity> scores;
+    order_moves(moves, ply, tt_move, scores);
+
+    const auto  original_alpha = alpha;
+    score_t     best = -infinite_score;
+    packed_move best_move;
+
+    for (std::size_t i = 0; i < moves.size(); ++i) {
+        pick_next(moves, scores, i);
+        const auto& move = moves[i];
+
+        make(move);
+        const auto score = -negamax(depth - 1, ply + 1, -beta, -alpha);
+        unmake();
+
+        if (m_aborted) {
+            return draw_score;
+        }
+
+        if (score <= best) {
+            continue;
+        }
+        best = score;
+
+        if (score <= alpha) {
+            continue;
+        }
+        alpha = score;
+        best_move = packed_move{move};
+
+        update_pv(ply, move);
+
+        if (alpha >= beta) {
+            if (!move.is_capture() && !move.is_promotion()) {
+                auto& killers = m_killers[ply];
+                if (!killers[0] || !same_move(*killers[0], move)) {
+                    killers[1] = killers[0];
+                    killers[0] = move;
+                }
+            }
+            break;
+        }
+    }
+
+    const auto bound = best >= beta ? bound_t::Lower : best > original_alpha ? bound_t::Exact : bound_t::Upper;
+    m_tt.store(key, depth, score_to_tt(best, ply), bound, best_move);
+
+    return best;
+}
+
+score_t search_worker::quiescence(int ply, score_t alpha, score_t beta)
+{
+    m_pv_length[ply] = ply;
+
+    if (should_stop()) {
+        return draw_score;
+    }
+
+    ++m_nodes;
+
+    const auto us = side_to_move(m_state);
+    if (ply >= max_ply - 1) {
+        return evaluate(m_board, us);
+    }
+
+    move_list moves;
+    score_t   best = -infinite_score;
+
+    if (move_generator::is_in_check(m_board, m_state.get_player_turn())) {
+        // No standing pat in check: every evasion is tried, which also finds the mates
+        move_generator::generate<gen_mode::Evasions>(m_board, m_state, moves);
+        if (moves.empty()) {
+            return -mate_score + ply;
+        }
+    } else {
+        // The side to move may decline every capture and keep the static score
+        best = evaluate(m_board, us);
+        if (best >= beta) {
+            return best;
+        }
+        alpha = std::max(alpha, best);
+
+        move_generator::generate<gen_mode::Captures>(m_board, m_state, moves);
+    }
+
+    std::array<int, move_list::capacity> scores;
+    order_moves(moves, ply, packed_move{}, scores);
+
+    for (std::size_t i = 0; i < moves.size(); ++i) {
+        pick_next(moves, scores, i);
+        const auto& move = moves[i];
+
+        make(move);
+        const auto score = -quiescence(ply + 1, -beta, -alpha);
+        unmake();
+
+        if (m_aborted) {
+            return draw_score;
+        }
+
+        if (score <= best) {
+            continue;
+        }
+        best = score;
+
+        if (score <= alpha) {
+            continue;
+        }
+        alpha = score;
+
+        update_pv(ply, move);
+
+        if (alpha >= beta) {
+            break;
+        }
+    }
+
+    return best;
+}
+
+void search_worker::update_pv(int ply, const move_info& move) noexcept
+{
+    // The new best move followed by the line the child found below it
+    const auto& child = m_pv[ply + 1];
+
+    m_pv[ply][ply] = move;
+    std::copy(child.begin() + ply + 1, child.begin() + m_pv_length[ply + 1], m_pv[ply].begin() + ply + 1);
+    m_pv_length[ply] = m_pv_length[ply + 1];
+}
+
+void search_worker::order_moves(move_list&                            moves,
+                                int                                   ply,
+                                packed_move                           tt_move,
+                                std::array<int, move_list::capacity>& scores) const
+{
+    const auto& killers = m_killers[ply];
+    const bool  has_pv_move = static_cast<std::size_t>(ply) < m_previous_pv.size();
+
+    for (std::size_t i = 0; i < moves.size(); ++i) {
+        const auto& move = moves[i];
+
+        if (tt_move != packed_move{} && packed_move{move} == tt_move) {
+            scores[i] = tt_move_order;
+        } else if (has_pv_move && same_move(move, m_previous_pv[ply])) {
+            scores[i] = pv_move_order;
+        } else if (move.is_capture() || move.is_promotion()) {
+            // Most valuable victim first, cheapest attacker first among equal victims
+            const auto victim = move.is_en_passant() ? piece_t::type_t::Pawn : m_board[move.to].get_type();
+            const auto attacker = m_board[move.from].get_type();
+
+            scores[i] = capture_order + piece_values[std::to_underlying(victim)] * 10 -
+                        piece_values[std::to_underlying(attacker)] / 10;
+            if (move.is_promotion()) {
+                scores[i] += piece_values[move.promotion_piece];
+            }
+        } else if (killers[0] && same_move(*killers[0], move)) {
+            scores[i] = killer_order;
+        } else if (killers[1] && same_move(*killers[1], move)) {
+            scores[i] = killer_order - 1;
+        } else {
+            scores[i] = 0;
+        }
+    }
+}
+
+void search_worker::pick_next(move_list& moves, std::array<int, move_list::capacity>& scores, std::size_t index) const
+{
+    // Selection sort one step at a time: a cutoff usually comes early, so sorting the whole list is wasted work
+    auto best = index;
+    for (auto i = index + 1; i < moves.size(); ++i) {
+        if (scores[i] > scores[best]) {
+            best = i;
+        }
+    }
+
+    std::swap(moves[index], moves[best]);
+    std::swap(scores[index], scores[best]);
+}
+
+bool search_worker::should_stop() noexcept
+{
+    if (m_aborted) {
+        return true;
+    }
+
+    if ((m_limits.nodes != 0 && m_nodes >= m_limits.nodes) || m_stop.load(std::memory_order_relaxed) ||
+        (m_has_searched_move && m_nodes % time_check_interval == 0 && m_time.is_hard_limit_reached())) {
+        m_aborted = true;
+    }
+    return m_aborted;
+}
+
+void search_worker::make(const move_info& move)
+{
+    m_undo.push_back(m_board.make_move(move, m_state));
+
+    // The child probes this bucket once past its draw and check tests, by then the line is on its way
+    const auto key = position_key(m_board, m_state);
+    m_tt.prefetch(key);
+    m_history.push(key);
+}
+
+void search_worker::unmake()
+{
+    m_history.pop();
+    m_board.unmake_move(m_undo.back(), m_state);
+    m_undo.pop_back();
+}
+
+}  // namespace chessfml::engine
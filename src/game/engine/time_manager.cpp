@@ -0,0 +1,80 @@
+#include "game/engine/time_manager.hpp"
+
+#include "game/engine/search.hpp"
+
+#include <algorithm>
+#include <array>
+
+namespace {
+
+using namespace std::chrono_literals;
+
+// Kept back from every budget for the time it takes to return and play the move
+constexpr auto move_overhead = 20ms;
+
+// Moves the remaining clock is spread over when the number of moves to the next time control is unknown
+constexpr int default_moves_to_go = 30;
+
+// The hard limit lets a move run this many times over its share, when an iteration is still going
+constexpr int hard_limit_factor = 4;
+
+// Never spend more than this fraction of the remaining clock on a single move
+constexpr double max_clock_fraction = 0.4;
+
+// Soft limit multiplier, indexed by how many iterations in a row kept the same best move. A move that just
+// changed gets extra time, a move that has held for three iterations half of it
+constexpr std::array<double, 4> stability_scale = {1.25, 0.9, 0.7, 0.5};
+
+}  // anonymous namespace
+
+namespace chessfml::engine {
+
+time_manager::time_manager(const search_limits& limits)
+{
+    if (limits.move_time > clock::duration::zero()) {
+        m_soft_limit = std::max<clock::duration>(limits.move_time - move_overhead, 1ms);
+        m_hard_limit = m_soft_limit;
+        m_enabled = true;
+    } else if (limits.time_left > clock::duration::zero()) {
+        const int  moves_to_go = limits.moves_to_go > 0 ? limits.moves_to_go : default_moves_to_go;
+        const auto usable = std::max<clock::duration>(limits.time_left - move_overhead, 1ms);
+        const auto cap = std::chrono::duration_cast<clock::duration>(usable * max_clock_fraction);
+
+        // The increment comes back after the move, so most of it can be spent now
+        const auto share = usable / moves_to_go + limits.increment * 3 / 4;
+
+        m_soft_limit = std::clamp<clock::duration>(share, 1ms, cap);
+        m_hard_limit = std::clamp<clock::duration>(share * hard_limit_factor, m_soft_limit, cap);
+        m_enabled = true;
+        m_scale_with_stability = true;
+    }
+
+    m_hard_deadline = m_start + m_hard_limit;
+}
+
+void time_manager::on_iteration(const move_info& best_move) noexcept
+{
+    const bool same = m_iterations > 0 && best_move.from == m_last_best.from && best_move.to == m_last_best.to &&
+                      best_move.promotion_piece == m_last_best.promotion_piece;
+
+    m_stable_iterations = same ? m_stable_iterations + 1 : 0;
+    m_last_best = best_move;
+    ++m_iterations;
+}
+
+bool time_manager::should_stop_deepening() const noexcept
+{
+    // A fixed move time is used up, the hard limit ends the search
+    if (!m_scale_with_stability) {
+        return false;
+    }
+
+    const auto index = std::min<std::size_t>(m_stable_iterations, stability_scale.size() - 1);
+    const auto budget = std::chrono::duration<double>(m_soft_limit) * stability_scale[index];
+
+    // Each iteration costs a few times the previous one, so one started past half the budget would not finish
+    // inside it, and the hard limit would throw its work away
+    return elapsed() >= budget / 2;
+}
+
+}  // namespace chessfml::engine
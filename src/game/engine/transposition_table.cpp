@@ -0,0 +1,84 @@
+#include "game/engine/transposition_table.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <utility>
+
+namespace chessfml::engine {
+
+void transposition_table::resize(std::size_t size_mb)
+{
+    const auto bytes = std::max<std::size_t>(size_mb, 1) << 20;
+
+    // A power of two keeps the index a mask of the key. Value-initialized, so every entry starts empty
+    m_buckets = std::vector<bucket>(std::bit_floor(bytes / sizeof(bucket)));
+    m_mask = m_buckets.size() - 1;
+    m_generation = 0;
+}
+
+void transposition_table::clear() noexcept
+{
+    for (auto& b : m_buckets) {
+        for (auto& e : b.entries) {
+            e.key_xor_data.store(0, std::memory_order_relaxed);
+            e.data.store(0, std::memory_order_relaxed);
+        }
+    }
+    m_generation = 0;
+}
+
+std::optional<tt_hit> transposition_table::probe(zobrist_t key) const noexcept
+{
+    for (const auto& e : m_buckets[index(key)].entries) {
+        const auto d = e.load();
+        if (e.key(d) == key && d.bound() != bound_t::None) {
+            return tt_hit{.move = d.move, .score = d.score, .depth = d.depth, .bound = d.bound()};
+        }
+    }
+    return std::nullopt;
+}
+
+void transposition_table::store(zobrist_t key, int depth, score_t score, bound_t bound, packed_move move) noexcept
+{
+    auto& entries = m_buckets[index(key)].entries;
+
+    // The same position if it is there, otherwise the entry worth the least: empty first, then the shallowest
+    // once the age is counted against it
+    entry*     target = &entries[0];
+    entry_data old = target->load();
+    bool       same_key = false;
+
+    for (auto& e : entries) {
+        const auto d = e.load();
+        if (e.key(d) == key || d.bound() == bound_t::None) {
+            target = &e;
+            old = d;
+            same_key = d.bound() != bound_t::None;
+            break;
+        }
+        if (d.depth - age_weight * age(d) < old.depth - age_weight * age(old)) {
+            target = &e;
+            old = d;
+        }
+    }
+
+    if (same_key) {
+        // A deeper bound from this search is usually worth more than a shallower one, unless that is exact
+        if (bound != bound_t::Exact && age(old) == 0 && depth + 2 < old.depth) {
+            return;
+        }
+        if (move == packed_move{}) {
+            move = old.move;
+        }
+    }
+
+    target->save(key,
+                 entry_data{.move = move,
+                            .score = static_cast<std::int16_t>(score),
+                            .depth = static_cast<std::uint8_t>(depth),
+                            .bound_generation =
+                                static_cast<std::uint8_t>(std::to_underlying(bound) | (m_generation << 2)),
+                            .padding = 0});
+}
+
+}  // namespace chessfml::engine
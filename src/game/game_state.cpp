@@ -25,25 +25,25 @@ bool game_state::can_castle_queenside(player_turn player) const
 void game_state::disable_kingside_castling(player_turn player)
 {
     const auto flag = (player == player_turn::White) ? WHITE_KINGSIDE_FLAG : BLACK_KINGSIDE_FLAG;
-    m_castling_rights &= ~flag;
+    set_castling_rights(m_castling_rights & ~flag);
 }
 
 void game_state::disable_queenside_castling(player_turn player)
 {
     const auto flag = (player == player_turn::White) ? WHITE_QUEENSIDE_FLAG : BLACK_QUEENSIDE_FLAG;
-    m_castling_rights &= ~flag;
+    set_castling_rights(m_castling_rights & ~flag);
 }
 
 void game_state::enable_kingside_castling(player_turn player) noexcept
 {
     const auto flag = (player == player_turn::White) ? WHITE_KINGSIDE_FLAG : BLACK_KINGSIDE_FLAG;
-    m_castling_rights |= flag;
+    set_castling_rights(m_castling_rights | flag);
 }
 
 void game_state::enable_queenside_castling(player_turn player) noexcept
 {
     const auto flag = (player == player_turn::White) ? WHITE_QUEENSIDE_FLAG : BLACK_QUEENSIDE_FLAG;
-    m_castling_rights |= flag;
+    set_castling_rights(m_castling_rights | flag);
 }
 
 void game_state::update_move_counters(bool is_capture_or_pawn_move) noexcept
@@ -0,0 +1,27 @@
+#include "game/key_history.hpp"
+
+#include <algorithm>
+
+namespace chessfml {
+
+int key_history::repetitions(int halfmove_clock) const noexcept
+{
+    if (m_keys.empty()) {
+        return 0;
+    }
+
+    const auto latest = m_keys.back();
+    const auto window = std::min(static_cast<std::size_t>(std::max(halfmove_clock, 0)), m_keys.size() - 1);
+
+    // The side to move alternates, so only every other position can match, and none sooner than four plies back
+    int count = 0;
+    for (std::size_t back = 4; back <= window; back += 2) {
+        if (m_keys[m_keys.size() - 1 - back] == latest) {
+            ++count;
+        }
+    }
+
+    return count;
+}
+
+}  // namespace chessfml
@@ -1,62 +1,50 @@
 #include "game/moves.hpp"
 
+#include "common/attack_tables.hpp"
 #include "common/config.hpp"
 #include "common/utils.hpp"
+#include "game/attacks.hpp"
 
 #include <algorithm>
 #include <array>
 
 namespace {
 
-constexpr std::array<std::pair<int, int>, 8> knight_offsets = {
-    {{-2, -1}, {-2, 1}, {-1, -2}, {-1, 2}, {1, -2}, {1, 2}, {2, -1}, {2, 1}}};
-
-constexpr std::array<std::pair<int, int>, 8> king_offsets = {
-    {{-1, -1}, {-1, 0}, {-1, 1}, {0, -1}, {0, 1}, {1, -1}, {1, 0}, {1, 1}}};
-
-constexpr std::array<std::pair<int, int>, 4> rook_directions = {{{-1, 0}, {0, -1}, {0, 1}, {1, 0}}};
-
-constexpr std::array<std::pair<int, int>, 4> bishop_directions = {{{-1, -1}, {-1, 1}, {1, -1}, {1, 1}}};
-
-std::vector<chessfml::move_info> get_sliding_piece_moves(const chessfml::board_t&             board,
-                                                         chessfml::move_t                     pos,
-                                                         std::span<const std::pair<int, int>> directions)
+// Turns an attack set into moves, skipping squares held by the moving side
+template <chessfml::piece_t::color_t Us>
+void add_moves(const chessfml::board_t& board,
+               chessfml::move_t         pos,
+               chessfml::bitboard_t     attack_set,
+               chessfml::move_list&     moves)
 {
     using namespace chessfml;
 
-    std::vector<move_info> moves;
-    const auto&            piece = board[pos];
-    const auto [rank, file] = position_to_rank_file(pos);
-
-    constexpr int board_size = config::board::size;
+    const auto enemies = board.pieces(opposite(Us));
 
-    for (const auto& [dr, df] : directions) {
-        for (int i = 1; i < board_size; ++i) {
-            int new_rank = rank + dr * i;
-            int new_file = file + df * i;
+    for (auto targets = attack_set & ~board.pieces(Us); targets != bitboard::empty;) {
+        const move_t new_pos = bitboard::pop_lsb(targets);
 
-            if (new_rank < 0 || new_rank >= board_size || new_file < 0 || new_file >= board_size) {
-                break;
-            }
-
-            move_t      new_pos = rank_file_to_position(new_rank, new_file);
-            const auto& target = board[new_pos];
-
-            if (target.get_type() == piece_t::type_t::Empty) {
-                // Empty square - valid move
-                moves.push_back({.from = pos, .to = new_pos});
-            } else {
-                // Hit a piece
-                if (target.get_color() != piece.get_color()) {
-                    // Enemy piece - can capture
-                    moves.push_back({.from = pos, .to = new_pos, .type = move_type_flag::Capture});
-                }
-                break;  // Stop in this direction after hitting a piece
-            }
+        if (bitboard::test(enemies, new_pos)) {
+            moves.push_back({.from = pos, .to = new_pos, .type = move_type_flag::Capture});
+        } else {
+            moves.push_back({.from = pos, .to = new_pos});
         }
     }
+}
+
+// Same as above for callers that only know the color at runtime
+void add_moves(const chessfml::board_t& board,
+               chessfml::move_t         pos,
+               chessfml::bitboard_t     attack_set,
+               chessfml::move_list&     moves)
+{
+    using namespace chessfml;
 
-    return moves;
+    if (board[pos].get_color() == piece_t::color_t::White) {
+        add_moves<piece_t::color_t::White>(board, pos, attack_set, moves);
+    } else {
+        add_moves<piece_t::color_t::Black>(board, pos, attack_set, moves);
+    }
 }
 
 }  // anonymous namespace
@@ -65,110 +53,87 @@ namespace chessfml {
 
 std::vector<move_info> move_generator::get_legal_moves(const board_t& board, const game_state& state, move_t pos)
 {
-    auto moves = get_pseudo_legal_moves(board, state, pos);
-
-    const auto& piece = board[pos];
-    const auto  player = (piece.get_color() == piece_t::color_t::White) ? game_state::player_turn::White
-                                                                        : game_state::player_turn::Black;
-
-    // Filter out moves that would leave or put the king in check
-    std::erase_if(moves, [&piece, &player, &board](const move_info& move) {
-        board_t temp_board = board;
-
-        if (move.type == move_type_flag::EnPassant) {
-            const auto [capture_rank, capture_file] = position_to_rank_file(move.to);
-            const int    ep_rank = piece.get_color() == piece_t::color_t::White ? capture_rank + 1 : capture_rank - 1;
-            const move_t ep_pos = rank_file_to_position(ep_rank, capture_file);
-            temp_board[ep_pos] = piece_t{};  // Empty the captured pawn's square
-        }
-
-        if (move.type == move_type_flag::Castling) {
-            const bool is_kingside = move.to > move.from;
-
-            if (is_kingside) {
-                const move_t rook_from = (player == game_state::player_turn::White) ? 7 : 63;
-                const move_t rook_to = (player == game_state::player_turn::White) ? 5 : 61;
-
-                temp_board[rook_to] = temp_board[rook_from];
-                temp_board[rook_to].set_pos(rook_to);
-                temp_board[rook_from] = piece_t{};
-            } else {
-                const move_t rook_from = (player == game_state::player_turn::White) ? 0 : 56;
-                const move_t rook_to = (player == game_state::player_turn::White) ? 3 : 59;
-
-                temp_board[rook_to] = temp_board[rook_from];
-                temp_board[rook_to].set_pos(rook_to);
-                temp_board[rook_from] = piece_t{};
-            }
-        }
+    move_list moves;
+    get_legal_moves(board, state, pos, moves);
 
-        // Execute the move on the temporary board
-        temp_board[move.to] = temp_board[move.from];
-        temp_board[move.to].set_pos(move.to);
-        temp_board[move.from] = piece_t{};
+    return {moves.begin(), moves.end()};
+}
 
-        // Check if the king would be in check after this move
-        return is_in_check(temp_board, player);
-    });
+void move_generator::get_legal_moves(const board_t& board, const game_state& state, move_t pos, move_list& moves)
+{
+    if (board.is_empty(pos)) {
+        return;
+    }
 
-    return moves;
+    generate_legal_moves(board, state, pos, compute_legality_info(board, board[pos].get_color()), moves);
 }
 
 bool move_generator::is_legal_move(const board_t& board, const game_state& state, move_t from, move_t to)
 {
-    const auto legal_moves = get_legal_moves(board, state, from);
+    move_list legal_moves;
+    get_legal_moves(board, state, from, legal_moves);
 
     // Check if the destination 'to' is in the list of legal moves
     return std::ranges::any_of(legal_moves, [to](const auto& move) { return move.to == to; });
 }
 
 std::vector<move_info> move_generator::get_pseudo_legal_moves(const board_t& board, const game_state& state, move_t pos)
+{
+    move_list moves;
+    get_pseudo_legal_moves(board, state, pos, moves);
+
+    return {moves.begin(), moves.end()};
+}
+
+void move_generator::get_pseudo_legal_moves(const board_t&    board,
+                                            const game_state& state,
+                                            move_t            pos,
+                                            move_list&        moves)
 {
     const auto& piece = board[pos];
 
     switch (piece.get_type()) {
         case piece_t::type_t::Pawn:
-            return get_pawn_moves(board, state, pos);
+            get_pawn_moves(board, state, pos, moves);
+            break;
         case piece_t::type_t::Rook:
-            return get_rook_moves(board, pos);
+            get_rook_moves(board, pos, moves);
+            break;
         case piece_t::type_t::Knight:
-            return get_knight_moves(board, pos);
+            get_knight_moves(board, pos, moves);
+            break;
         case piece_t::type_t::Bishop:
-            return get_bishop_moves(board, pos);
+            get_bishop_moves(board, pos, moves);
+            break;
         case piece_t::type_t::Queen:
-            return get_queen_moves(board, pos);
+            get_queen_moves(board, pos, moves);
+            break;
         case piece_t::type_t::King:
-            return get_king_moves(board, state, pos);
+            get_king_moves(board, state, pos, moves);
+            break;
         default:
-            return {};
+            break;
     }
 }
 
 bool move_generator::is_in_check(const board_t& board, game_state::player_turn player)
 {
-    const auto king_color =
-        (player == game_state::player_turn::White) ? piece_t::color_t::White : piece_t::color_t::Black;
+    const bool is_white = player == game_state::player_turn::White;
 
-    move_t king_pos = 0xFF;  // Invalid position
-
-    for (move_t i = 0; i < config::board::size * config::board::size; ++i) {
-        const auto& piece = board[i];
-        if (piece.get_type() == piece_t::type_t::King && piece.get_color() == king_color) {
-            king_pos = i;
-            break;
-        }
-    }
-
-    if (king_pos == 0xFF) {
+    const move_t king_pos = board.king_square(is_white ? piece_t::color_t::White : piece_t::color_t::Black);
+    if (king_pos == board_t::no_square) {
         // King not found (shouldn't happen in a valid board)
         return false;
     }
 
-    // Check if the king is attacked
-    return is_square_attacked(
-        board,
-        king_pos,
-        (player == game_state::player_turn::White) ? game_state::player_turn::Black : game_state::player_turn::White);
+    return is_white ? is_square_attacked<piece_t::color_t::Black>(board, king_pos)
+                    : is_square_attacked<piece_t::color_t::White>(board, king_pos);
+}
+
+bool move_generator::is_square_attacked(const board_t& board, move_t square, piece_t::color_t attacker)
+{
+    return attacker == piece_t::color_t::White ? is_square_attacked<piece_t::color_t::White>(board, square)
+                                               : is_square_attacked<piece_t::color_t::Black>(board, square);
 }
 
 bool move_generator::is_checkmate(const board_t& board, const game_state& state)
@@ -185,13 +150,12 @@ bool move_generator::is_stalemate(const board_t& board, const game_state& state)
     return !is_in_check(board, player_turn) && !has_legal_moves(board, state);
 }
 
-std::vector<move_info> move_generator::get_pawn_moves(const board_t& board, const game_state& state, move_t pos)
+void move_generator::get_pawn_moves(const board_t& board, const game_state& state, move_t pos, move_list& moves)
 {
-    std::vector<move_info> moves;
-    const auto&            pawn = board[pos];
+    const auto& pawn = board[pos];
 
     if (pawn.get_type() != piece_t::type_t::Pawn) {
-        return moves;
+        return;
     }
 
     const bool is_white = (pawn.get_color() == piece_t::color_t::White);
@@ -202,7 +166,7 @@ std::vector<move_info> move_generator::get_pawn_moves(const board_t& board, cons
 
     // Check if we're at the last rank (shouldn't happen in a valid board, since you promote)
     if ((is_white && rank == 0) || (!is_white && rank == board_size - 1)) {
-        return moves;
+        return;
     }
 
     // Single step forward
@@ -225,8 +189,8 @@ std::vector<move_info> move_generator::get_pawn_moves(const board_t& board, cons
                 // Normal move
                 moves.push_back({.from = pos, .to = forward_pos});
 
-                // Double step from starting position
-                if (!pawn.has_moved()) {
+                // Double step from the starting rank
+                if (rank == (is_white ? board_size - 2 : 1)) {
                     const int double_rank = rank + 2 * direction;
                     if (double_rank >= 0 && double_rank < board_size) {
                         const move_t double_pos = rank_file_to_position(double_rank, file);
@@ -275,109 +239,62 @@ std::vector<move_info> move_generator::get_pawn_moves(const board_t& board, cons
             }
         }
     }
-
-    return moves;
 }
 
-std::vector<move_info> move_generator::get_rook_moves(const board_t& board, move_t pos)
+void move_generator::get_rook_moves(const board_t& board, move_t pos, move_list& moves)
 {
-    return get_sliding_piece_moves(board, pos, rook_directions);
+    add_moves(board, pos, attacks::rook_attacks(pos, board.occupancy()), moves);
 }
 
-std::vector<move_info> move_generator::get_knight_moves(const board_t& board, move_t pos)
+void move_generator::get_knight_moves(const board_t& board, move_t pos, move_list& moves)
 {
-    std::vector<move_info> moves;
-    const auto&            knight = board[pos];
-    const auto [rank, file] = position_to_rank_file(pos);
-
-    constexpr int board_size = config::board::size;
-
-    for (const auto& [dr, df] : knight_offsets) {
-        int new_rank = rank + dr;
-        int new_file = file + df;
-
-        if (new_rank < 0 || new_rank >= board_size || new_file < 0 || new_file >= board_size) {
-            continue;
-        }
-
-        move_t      new_pos = rank_file_to_position(new_rank, new_file);
-        const auto& target = board[new_pos];
-
-        if (target.get_type() == piece_t::type_t::Empty) {
-            moves.push_back({.from = pos, .to = new_pos});
-        } else if (target.get_color() != knight.get_color()) {
-            moves.push_back({.from = pos, .to = new_pos, .type = move_type_flag::Capture});
-        }
-    }
-
-    return moves;
+    add_moves(board, pos, attacks::knight_attacks(pos), moves);
 }
 
-std::vector<move_info> move_generator::get_bishop_moves(const board_t& board, move_t pos)
+void move_generator::get_bishop_moves(const board_t& board, move_t pos, move_list& moves)
 {
-    return get_sliding_piece_moves(board, pos, bishop_directions);
+    add_moves(board, pos, attacks::bishop_attacks(pos, board.occupancy()), moves);
 }
 
-std::vector<move_info> move_generator::get_queen_moves(const board_t& board, move_t pos)
+void move_generator::get_queen_moves(const board_t& board, move_t pos, move_list& moves)
 {
-    // Queen moves are a combination of rook and bishop moves
-    const auto rook_moves = get_rook_moves(board, pos);
-    const auto bishop_moves = get_bishop_moves(board, pos);
-
-    std::vector<move_info> queen_moves;
-    queen_moves.reserve(rook_moves.size() + bishop_moves.size());
-
-    queen_moves.insert(
-        queen_moves.end(), std::make_move_iterator(rook_moves.begin()), std::make_move_iterator(rook_moves.end()));
-    queen_moves.insert(
-        queen_moves.end(), std::make_move_iterator(bishop_moves.begin()), std::make_move_iterator(bishop_moves.end()));
-
-    return queen_moves;
+    // Queen moves are a combination of rook and bishop moves, generated from a single attack set
+    add_moves(board, pos, attacks::queen_attacks(pos, board.occupancy()), moves);
 }
 
-std::vector<move_info> move_generator::get_king_moves(const board_t& board, const game_state& state, move_t pos)
+void move_generator::get_king_moves(const board_t& board, const game_state& state, move_t pos, move_list& moves)
 {
-    std::vector<move_info> moves;
-    const auto&            king = board[pos];
-    const auto [rank, file] = position_to_rank_file(pos);
-    const auto king_color = king.get_color();
-
-    // Convert piece color to player turn for state queries
-    const auto player =
-        (king_color == piece_t::color_t::White) ? game_state::player_turn::White : game_state::player_turn::Black;
-
-    constexpr int board_size = config::board::size;
-
-    for (const auto& [dr, df] : king_offsets) {
-        int new_rank = rank + dr;
-        int new_file = file + df;
-
-        if (new_rank < 0 || new_rank >= board_size || new_file < 0 || new_file >= board_size) {
-            continue;
-        }
+    if (board[pos].get_color() == piece_t::color_t::White) {
+        get_king_moves<piece_t::color_t::White>(board, state, pos, moves);
+    } else {
+        get_king_moves<piece_t::color_t::Black>(board, state, pos, moves);
+    }
+}
 
-        move_t      new_pos = rank_file_to_position(new_rank, new_file);
-        const auto& target = board[new_pos];
+template <piece_t::color_t Us>
+void move_generator::get_king_moves(const board_t& board, const game_state& state, move_t pos, move_list& moves)
+{
+    constexpr auto them = opposite(Us);
+    constexpr bool is_white = Us == piece_t::color_t::White;
+    constexpr auto player = is_white ? game_state::player_turn::White : game_state::player_turn::Black;
 
-        if (is_square_attacked(board,
-                               new_pos,
-                               (player == game_state::player_turn::White) ? game_state::player_turn::Black
-                                                                          : game_state::player_turn::White)) {
-            continue;
-        }
+    // Steps onto attacked squares are dropped here, the rest is left to the legality filter
+    for (auto targets = attacks::king_attacks(pos) & ~board.pieces(Us); targets != bitboard::empty;) {
+        const move_t new_pos = bitboard::pop_lsb(targets);
 
-        if (target.get_type() == piece_t::type_t::Empty) {
-            moves.push_back({.from = pos, .to = new_pos});
-        } else if (target.get_color() != king.get_color()) {
-            moves.push_back({.from = pos, .to = new_pos, .type = move_type_flag::Capture});
+        if (!is_square_attacked<them>(board, new_pos)) {
+            add_moves<Us>(board, pos, bitboard::square(new_pos), moves);
         }
     }
 
-    // Castling moves
-    if (!king.has_moved() && !state.is_check()) {
+    // Castling moves, never out of check. The attack test is done here rather than trusting the cached
+    // check flag, which make_move leaves to the caller
+    constexpr move_t home = is_white ? 60 : 4;
+    if (pos == home && (state.can_castle_kingside(player) || state.can_castle_queenside(player)) &&
+        !is_square_attacked<them>(board, pos)) {
         if (state.can_castle_kingside(player)) {
-            const move_t rook_pos = (king_color == piece_t::color_t::White) ? 7 : 63;
-            const move_t king_path[] = {static_cast<move_t>(pos + 1), static_cast<move_t>(pos + 2)};
+            constexpr move_t rook_pos = is_white ? 63 : 7;
+            constexpr move_t king_path[] = {home + 1, home + 2};
 
             bool path_clear = true;
 
@@ -392,31 +309,24 @@ std::vector<move_info> move_generator::get_king_moves(const board_t& board, cons
             // Check if squares the king moves through are not under attack
             if (path_clear) {
                 for (int i = 0; i < 2; ++i) {
-                    if (is_square_attacked(board,
-                                           king_path[i],
-                                           (player == game_state::player_turn::White)
-                                               ? game_state::player_turn::Black
-                                               : game_state::player_turn::White)) {
+                    if (is_square_attacked<them>(board, king_path[i])) {
                         path_clear = false;
                         break;
                     }
                 }
             }
 
-            // Verify the rook is there and hasn't moved
-            if (path_clear && board[rook_pos].get_type() == piece_t::type_t::Rook &&
-                board[rook_pos].get_color() == king_color && !board[rook_pos].has_moved()) {
-
-                moves.push_back({.from = pos, .to = static_cast<move_t>(pos + 2), .type = move_type_flag::Castling});
+            // Verify the rook is there, the castling right guarantees it never moved
+            if (path_clear && board[rook_pos] == piece_t{piece_t::type_t::Rook, Us}) {
+                moves.push_back({.from = pos, .to = home + 2, .type = move_type_flag::Castling});
             }
         }
 
         // Queenside castling
         if (state.can_castle_queenside(player)) {
-            const move_t rook_pos = (king_color == piece_t::color_t::White) ? 0 : 56;
-            const move_t king_path[] = {static_cast<move_t>(pos - 1), static_cast<move_t>(pos - 2)};
-            const move_t full_path[] = {
-                static_cast<move_t>(pos - 1), static_cast<move_t>(pos - 2), static_cast<move_t>(pos - 3)};
+            constexpr move_t rook_pos = is_white ? 56 : 0;
+            constexpr move_t king_path[] = {home - 1, home - 2};
+            constexpr move_t full_path[] = {home - 1, home - 2, home - 3};
 
             bool path_clear = true;
 
@@ -431,156 +341,533 @@ std::vector<move_info> move_generator::get_king_moves(const board_t& board, cons
             // Check if squares the king moves through are not under attack
             if (path_clear) {
                 for (int i = 0; i < 2; ++i) {  // Only check the squares the king moves through
-                    if (is_square_attacked(board,
-                                           king_path[i],
-                                           (player == game_state::player_turn::White)
-                                               ? game_state::player_turn::Black
-                                               : game_state::player_turn::White)) {
+                    if (is_square_attacked<them>(board, king_path[i])) {
                         path_clear = false;
                         break;
                     }
                 }
             }
 
-            // Verify the rook is there and hasn't moved
-            if (path_clear && board[rook_pos].get_type() == piece_t::type_t::Rook &&
-                board[rook_pos].get_color() == king_color && !board[rook_pos].has_moved()) {
-
-                moves.push_back({.from = pos, .to = static_cast<move_t>(pos - 2), .type = move_type_flag::Castling});
+            // Verify the rook is there, the castling right guarantees it never moved
+            if (path_clear && board[rook_pos] == piece_t{piece_t::type_t::Rook, Us}) {
+                moves.push_back({.from = pos, .to = home - 2, .type = move_type_flag::Castling});
             }
         }
     }
+}
+
+template <piece_t::color_t Attacker>
+bool move_generator::is_square_attacked(const board_t& board, move_t square)
+{
+    if (board.tracks_attacks()) {
+        return bitboard::test(board.attacked_by(Attacker), square);
+    }
+
+    const auto queens = board.pieces(piece_t::type_t::Queen, Attacker);
+    const auto straight_sliders = board.pieces(piece_t::type_t::Rook, Attacker) | queens;
+    const auto diagonal_sliders = board.pieces(piece_t::type_t::Bishop, Attacker) | queens;
+    const auto occupancy = board.occupancy();
+
+    // Leapers first, each a single table load. A pawn attacks the square iff a defending pawn standing on the
+    // square would attack the pawn
+    if ((attacks::pawn_attacks(opposite(Attacker), square) & board.pieces(piece_t::type_t::Pawn, Attacker)) !=
+        bitboard::empty) {
+        return true;
+    }
 
-    return moves;
+    if ((attacks::knight_attacks(square) & board.pieces(piece_t::type_t::Knight, Attacker)) != bitboard::empty) {
+        return true;
+    }
+
+    if ((attacks::king_attacks(square) & board.pieces(piece_t::type_t::King, Attacker)) != bitboard::empty) {
+        return true;
+    }
+
+    // Check rook, bishop and queen attacks through the slider tables
+    if ((attacks::rook_attacks(square, occupancy) & straight_sliders) != bitboard::empty) {
+        return true;
+    }
+
+    return (attacks::bishop_attacks(square, occupancy) & diagonal_sliders) != bitboard::empty;
 }
 
-bool move_generator::is_square_attacked(const board_t& board, move_t square, game_state::player_turn attacker_turn)
+legality_info move_generator::compute_legality_info(const board_t& board, piece_t::color_t color)
 {
-    const auto attacker_color =
-        (attacker_turn == game_state::player_turn::White) ? piece_t::color_t::White : piece_t::color_t::Black;
+    return color == piece_t::color_t::White ? compute_legality_info<piece_t::color_t::White>(board)
+                                            : compute_legality_info<piece_t::color_t::Black>(board);
+}
 
-    const auto [sq_rank, sq_file] = position_to_rank_file(square);
+template <piece_t::color_t Us>
+legality_info move_generator::compute_legality_info(const board_t& board)
+{
+    constexpr auto them = opposite(Us);
 
-    constexpr int board_size = config::board::size;
+    legality_info info{.color = Us,
+                       .king_pos = board.king_square(Us),
+                       .checkers = bitboard::empty,
+                       .check_mask = bitboard::full,
+                       .pinned = bitboard::empty};
 
-    // Check pawn attacks
-    const int pawn_dir = (attacker_color == piece_t::color_t::White) ? -1 : 1;
-    for (int df : {-1, 1}) {
-        int pawn_rank = sq_rank - pawn_dir;
-        int pawn_file = sq_file + df;
+    if (info.king_pos == board_t::no_square) {
+        // No king (shouldn't happen in a valid board), so nothing can be checked or pinned
+        return info;
+    }
+    const auto occupancy = board.occupancy();
 
-        if (pawn_rank < 0 || pawn_rank >= board_size || pawn_file < 0 || pawn_file >= board_size) {
-            continue;
-        }
+    info.checkers = attackers_to<them>(board, info.king_pos, occupancy);
 
-        move_t      pawn_pos = rank_file_to_position(pawn_rank, pawn_file);
-        const auto& piece = board[pawn_pos];
+    if (bitboard::count(info.checkers) > 1) {
+        info.check_mask = bitboard::empty;  // Double check, only the king may move
+    } else if (info.checkers != bitboard::empty) {
+        // Capture the checker, or block it when it is a slider
+        const auto checker = bitboard::lsb(info.checkers);
+        info.check_mask = bitboard::square(checker) | tables::between[info.king_pos][checker];
+    }
 
-        if (piece.get_type() == piece_t::type_t::Pawn && piece.get_color() == attacker_color) {
-            return true;
+    // Enemy sliders that would see the king through our own pieces
+    const auto their_pieces = board.pieces(them);
+    const auto their_queens = board.pieces(piece_t::type_t::Queen, them);
+    const auto snipers =
+        (attacks::rook_attacks(info.king_pos, their_pieces) &
+         (board.pieces(piece_t::type_t::Rook, them) | their_queens)) |
+        (attacks::bishop_attacks(info.king_pos, their_pieces) &
+         (board.pieces(piece_t::type_t::Bishop, them) | their_queens));
+
+    for (auto remaining = snipers; remaining != bitboard::empty;) {
+        const auto sniper = bitboard::pop_lsb(remaining);
+        const auto between = tables::between[info.king_pos][sniper];
+        const auto blockers = between & occupancy;
+
+        if (bitboard::count(blockers) == 1 && (blockers & board.pieces(Us)) != bitboard::empty) {
+            info.pinned |= blockers;
         }
     }
 
-    // Check knight attacks
-    for (const auto& [dr, df] : knight_offsets) {
-        int knight_rank = sq_rank + dr;
-        int knight_file = sq_file + df;
+    return info;
+}
 
-        if (knight_rank < 0 || knight_rank >= board_size || knight_file < 0 || knight_file >= board_size) {
-            continue;
+void move_generator::generate_legal_moves(const board_t&       board,
+                                          const game_state&    state,
+                                          move_t               pos,
+                                          const legality_info& info,
+                                          move_list&           moves)
+{
+    if (info.color == piece_t::color_t::White) {
+        generate_legal_moves<piece_t::color_t::White>(board, state, pos, info, moves);
+    } else {
+        generate_legal_moves<piece_t::color_t::Black>(board, state, pos, info, moves);
+    }
+}
+
+template <piece_t::color_t Us>
+void move_generator::generate_legal_moves(const board_t&       board,
+                                          const game_state&    state,
+                                          move_t               pos,
+                                          const legality_info& info,
+                                          move_list&           moves)
+{
+    const auto type = board[pos].get_type();
+
+    if (type == piece_t::type_t::King) {
+        generate_legal_king_moves<gen_mode::All, Us>(board, state, info, moves);
+        return;
+    }
+
+    if (info.check_mask == bitboard::empty) {
+        return;
+    }
+
+    const auto target_mask = info.check_mask & mode_targets<gen_mode::All, Us>(board);
+    const auto only = bitboard::square(pos);
+
+    // The per-type generators walk a bitboard of pieces, here holding just the one asked for
+    switch (type) {
+        case piece_t::type_t::Pawn:
+            generate_legal_pawn_moves<gen_mode::All, Us>(board, state, pos, info, moves);
+            break;
+        case piece_t::type_t::Knight:
+            generate_legal_piece_moves<piece_t::type_t::Knight, Us>(board, info, target_mask, only, moves);
+            break;
+        case piece_t::type_t::Bishop:
+            generate_legal_piece_moves<piece_t::type_t::Bishop, Us>(board, info, target_mask, only, moves);
+            break;
+        case piece_t::type_t::Rook:
+            generate_legal_piece_moves<piece_t::type_t::Rook, Us>(board, info, target_mask, only, moves);
+            break;
+        case piece_t::type_t::Queen:
+            generate_legal_piece_moves<piece_t::type_t::Queen, Us>(board, info, target_mask, only, moves);
+            break;
+        default:
+            break;
+    }
+}
+
+void move_generator::generate_all(const board_t& board, const game_state& state, move_list& moves)
+{
+    generate<gen_mode::All>(board, state, moves);
+}
+
+template <gen_mode Mode>
+void move_generator::generate(const board_t& board, const game_state& state, move_list& moves)
+{
+    // The only runtime color test of the whole generation
+    if (state.get_player_turn() == game_state::player_turn::White) {
+        generate<Mode, piece_t::color_t::White>(board, state, moves);
+    } else {
+        generate<Mode, piece_t::color_t::Black>(board, state, moves);
+    }
+}
+
+template void move_generator::generate<gen_mode::All>(const board_t&, const game_state&, move_list&);
+template void move_generator::generate<gen_mode::Captures>(const board_t&, const game_state&, move_list&);
+template void move_generator::generate<gen_mode::Quiets>(const board_t&, const game_state&, move_list&);
+template void move_generator::generate<gen_mode::Evasions>(const board_t&, const game_state&, move_list&);
+template void move_generator::generate<gen_mode::Checks>(const board_t&, const game_state&, move_list&);
+
+template <gen_mode Mode, piece_t::color_t Us>
+void move_generator::generate(const board_t& board, const game_state& state, move_list& moves)
+{
+    if constexpr (Mode == gen_mode::Checks) {
+        // Checking moves are rare enough that filtering the full list is cheaper than tracking every
+        // direct and discovered check square up front
+        move_list legal_moves;
+        generate<gen_mode::All, Us>(board, state, legal_moves);
+
+        for (const auto& move : legal_moves) {
+            if (gives_check<Us>(board, move)) {
+                moves.push_back(move);
+            }
         }
+    } else {
+        const auto info = compute_legality_info<Us>(board);
 
-        move_t      knight_pos = rank_file_to_position(knight_rank, knight_file);
-        const auto& piece = board[knight_pos];
+        if constexpr (Mode == gen_mode::Evasions) {
+            if (info.checkers == bitboard::empty) {
+                return;
+            }
+        }
 
-        if (piece.get_type() == piece_t::type_t::Knight && piece.get_color() == attacker_color) {
-            return true;
+        if (info.king_pos != board_t::no_square) {
+            generate_legal_king_moves<Mode, Us>(board, state, info, moves);
         }
-    }
 
-    // Check king attacks (adjacent squares)
-    for (const auto& [dr, df] : king_offsets) {
-        int king_rank = sq_rank + dr;
-        int king_file = sq_file + df;
+        if (info.check_mask == bitboard::empty) {
+            return;  // Double check, only the king may move
+        }
 
-        if (king_rank < 0 || king_rank >= board_size || king_file < 0 || king_file >= board_size) {
-            continue;
+        for (auto pawns = board.pieces(piece_t::type_t::Pawn, Us); pawns != bitboard::empty;) {
+            generate_legal_pawn_moves<Mode, Us>(board, state, bitboard::pop_lsb(pawns), info, moves);
         }
 
-        move_t      king_pos = rank_file_to_position(king_rank, king_file);
-        const auto& piece = board[king_pos];
+        const auto target_mask = info.check_mask & mode_targets<Mode, Us>(board);
 
-        if (piece.get_type() == piece_t::type_t::King && piece.get_color() == attacker_color) {
-            return true;
+        generate_legal_piece_moves<piece_t::type_t::Knight, Us>(
+            board, info, target_mask, board.pieces(piece_t::type_t::Knight, Us), moves);
+        generate_legal_piece_moves<piece_t::type_t::Bishop, Us>(
+            board, info, target_mask, board.pieces(piece_t::type_t::Bishop, Us), moves);
+        generate_legal_piece_moves<piece_t::type_t::Rook, Us>(
+            board, info, target_mask, board.pieces(piece_t::type_t::Rook, Us), moves);
+        generate_legal_piece_moves<piece_t::type_t::Queen, Us>(
+            board, info, target_mask, board.pieces(piece_t::type_t::Queen, Us), moves);
+    }
+}
+
+template <gen_mode Mode, piece_t::color_t Us>
+bitboard_t move_generator::mode_targets(const board_t& board)
+{
+    if constexpr (Mode == gen_mode::Captures) {
+        return board.pieces(opposite(Us));
+    } else if constexpr (Mode == gen_mode::Quiets) {
+        return ~board.occupancy();
+    } else {
+        return ~board.pieces(Us);
+    }
+}
+
+template <piece_t::type_t Type, piece_t::color_t Us>
+void move_generator::generate_legal_piece_moves(const board_t&       board,
+                                                const legality_info& info,
+                                                bitboard_t           target_mask,
+                                                bitboard_t           pieces,
+                                                move_list&           moves)
+{
+    const auto occupancy = board.occupancy();
+
+    // A pinned knight can never stay on its pin ray
+    if constexpr (Type == piece_t::type_t::Knight) {
+        pieces &= ~info.pinned;
+    }
+
+    while (pieces != bitboard::empty) {
+        const move_t pos = bitboard::pop_lsb(pieces);
+
+        // Restricted to the mode, the check mask and, when pinned, to the pin ray
+        auto targets = attacks::piece_attacks<Type>(pos, occupancy) & target_mask;
+        if (bitboard::test(info.pinned, pos)) {
+            targets &= tables::line[info.king_pos][pos];
         }
+
+        add_moves<Us>(board, pos, targets, moves);
     }
+}
 
-    // Check rook and queen attacks (horizontal and vertical)
-    for (const auto& [dr, df] : rook_directions) {
-        for (int i = 1; i < board_size; ++i) {
-            int r = sq_rank + dr * i;
-            int f = sq_file + df * i;
+bool move_generator::gives_check(const board_t& board, const move_info& move)
+{
+    return board[move.from].get_color() == piece_t::color_t::White
+               ? gives_check<piece_t::color_t::White>(board, move)
+               : gives_check<piece_t::color_t::Black>(board, move);
+}
 
-            if (r < 0 || r >= board_size || f < 0 || f >= board_size) {
-                break;
-            }
+template <piece_t::color_t Us>
+bool move_generator::gives_check(const board_t& board, const move_info& move)
+{
+    constexpr auto them = opposite(Us);
 
-            move_t      pos = rank_file_to_position(r, f);
-            const auto& piece = board[pos];
+    const auto king_pos = board.king_square(them);
+    if (king_pos == board_t::no_square) {
+        return false;
+    }
+    const auto type =
+        move.is_promotion() ? static_cast<piece_t::type_t>(move.promotion_piece) : board[move.from].get_type();
 
-            if (piece.get_type() != piece_t::type_t::Empty) {
-                if ((piece.get_type() == piece_t::type_t::Rook || piece.get_type() == piece_t::type_t::Queen) &&
-                    piece.get_color() == attacker_color) {
-                    return true;
-                }
-                break;  // Blocked by another piece
+    // Direct checks from leapers
+    if (type == piece_t::type_t::Knight && bitboard::test(attacks::knight_attacks(king_pos), move.to)) {
+        return true;
+    }
+    if (type == piece_t::type_t::Pawn && bitboard::test(attacks::pawn_attacks(them, king_pos), move.to)) {
+        return true;
+    }
+
+    // Replay the move on the occupancy and on our slider sets, then look for any slider seeing the king.
+    // This covers direct slider checks, discovered checks, promotions, en passant and the castling rook
+    const auto from_bb = bitboard::square(move.from);
+    const auto to_bb = bitboard::square(move.to);
+    const auto our_queens = board.pieces(piece_t::type_t::Queen, Us);
+
+    auto occupancy = (board.occupancy() ^ from_bb) | to_bb;
+    auto straight = (board.pieces(piece_t::type_t::Rook, Us) | our_queens) & ~from_bb;
+    auto diagonal = (board.pieces(piece_t::type_t::Bishop, Us) | our_queens) & ~from_bb;
+
+    if (type == piece_t::type_t::Rook || type == piece_t::type_t::Queen) {
+        straight |= to_bb;
+    }
+    if (type == piece_t::type_t::Bishop || type == piece_t::type_t::Queen) {
+        diagonal |= to_bb;
+    }
+
+    if (move.is_en_passant()) {
+        constexpr int push = Us == piece_t::color_t::White ? -config::board::size : config::board::size;
+        occupancy ^= bitboard::square(static_cast<move_t>(move.to - push));
+    }
+
+    if (move.is_castling()) {
+        const bool   is_kingside = move.to > move.from;
+        const move_t rook_from = is_kingside ? move.from + 3 : move.from - 4;
+        const move_t rook_to = is_kingside ? move.from + 1 : move.from - 1;
+
+        occupancy = (occupancy ^ bitboard::square(rook_from)) | bitboard::square(rook_to);
+        straight = (straight ^ bitboard::square(rook_from)) | bitboard::square(rook_to);
+    }
+
+    return (attacks::rook_attacks(king_pos, occupancy) & straight) != bitboard::empty ||
+           (attacks::bishop_attacks(king_pos, occupancy) & diagonal) != bitboard::empty;
+}
+
+template <gen_mode Mode, piece_t::color_t Us>
+void move_generator::generate_legal_pawn_moves(const board_t&       board,
+                                               const game_state&    state,
+                                               move_t               pos,
+                                               const legality_info& info,
+                                               move_list&           moves)
+{
+    constexpr bool is_white = Us == piece_t::color_t::White;
+    constexpr auto them = opposite(Us);
+    constexpr int  push = is_white ? -config::board::size : config::board::size;
+    constexpr int  start_rank = is_white ? config::board::size - 2 : 1;
+    constexpr int  promotion_rank = is_white ? 0 : config::board::size - 1;
+
+    const auto occupancy = board.occupancy();
+
+    auto allowed = info.check_mask;
+    if (bitboard::test(info.pinned, pos)) {
+        allowed &= tables::line[info.king_pos][pos];
+    }
+
+    // Promotions go with the captures in the staged modes, since they change the material balance
+    constexpr bool with_captures = Mode != gen_mode::Quiets;
+    constexpr bool with_quiets = Mode != gen_mode::Captures;
+
+    // Only the side's own last rank can be reached, and only from the rank before it
+    const bool promotes = pos / config::board::size == promotion_rank - push / config::board::size;
+
+    const auto add_pawn_move = [&](move_t to, move_type_flag type) {
+        if (promotes) {
+            for (auto promotion :
+                 {piece_t::type_t::Queen, piece_t::type_t::Rook, piece_t::type_t::Bishop, piece_t::type_t::Knight}) {
+                moves.push_back({.from = pos,
+                                 .to = to,
+                                 .type = type | move_type_flag::Promotion,
+                                 .promotion_piece = static_cast<std::uint8_t>(promotion)});
             }
+        } else {
+            moves.push_back({.from = pos, .to = to, .type = type});
+        }
+    };
+
+    // Pushes
+    const auto single = static_cast<move_t>(pos + push);
+    if (is_valid_position(single) && !bitboard::test(occupancy, single)) {
+        const bool wanted = promotes ? with_captures : with_quiets;
+        if (wanted && bitboard::test(allowed, single)) {
+            add_pawn_move(single, move_type_flag::Normal);
+        }
+
+        const auto twice = static_cast<move_t>(single + push);
+        if (with_quiets && pos / config::board::size == start_rank && !bitboard::test(occupancy, twice) &&
+            bitboard::test(allowed, twice)) {
+            moves.push_back({.from = pos, .to = twice});
         }
     }
 
-    // Check bishop and queen attacks (diagonal)
-    for (const auto& [dr, df] : bishop_directions) {
-        for (int i = 1; i < board_size; ++i) {
-            int r = sq_rank + dr * i;
-            int f = sq_file + df * i;
+    if constexpr (!with_captures) {
+        return;
+    }
+
+    // Captures
+    const auto pawn_attacks = attacks::pawn_attacks(Us, pos);
+    for (auto captures = pawn_attacks & board.pieces(them) & allowed; captures != bitboard::empty;) {
+        add_pawn_move(bitboard::pop_lsb(captures), move_type_flag::Capture);
+    }
 
-            if (r < 0 || r >= board_size || f < 0 || f >= board_size) {
-                break;
+    // En passant removes two pieces from the king's surroundings at once, which the pin and check masks do not
+    // describe, so the resulting position is tested directly
+    const auto ep_target = state.get_en_passant_target();
+    if (!ep_target || !bitboard::test(pawn_attacks, *ep_target)) {
+        return;
+    }
+
+    const auto captured_pos = static_cast<move_t>(*ep_target - push);
+    const auto captured_bb = bitboard::square(captured_pos);
+    const auto after =
+        (occupancy ^ bitboard::square(pos) ^ captured_bb) | bitboard::square(*ep_target);
+
+    const auto their_queens = board.pieces(piece_t::type_t::Queen, them);
+    const auto straight = board.pieces(piece_t::type_t::Rook, them) | their_queens;
+    const auto diagonal = board.pieces(piece_t::type_t::Bishop, them) | their_queens;
+
+    // Any checker other than the captured pawn must be a slider, and be blocked in the resulting position
+    const bool leaper_check_remains = (info.checkers & ~captured_bb & ~straight & ~diagonal) != bitboard::empty;
+    // A kingless side has nothing to expose, and the slider tables have no entry for no_square
+    const bool slider_check =
+        info.king_pos != board_t::no_square &&
+        ((attacks::rook_attacks(info.king_pos, after) & straight) != bitboard::empty ||
+         (attacks::bishop_attacks(info.king_pos, after) & diagonal) != bitboard::empty);
+
+    if (!leaper_check_remains && !slider_check) {
+        moves.push_back({.from = pos, .to = *ep_target, .type = move_type_flag::Capture | move_type_flag::EnPassant});
+    }
+}
+
+template <gen_mode Mode, piece_t::color_t Us>
+void move_generator::generate_legal_king_moves(const board_t&       board,
+                                               const game_state&    state,
+                                               const legality_info& info,
+                                               move_list&           moves)
+{
+    constexpr bool is_white = Us == piece_t::color_t::White;
+    constexpr auto them = opposite(Us);
+    constexpr auto player = is_white ? game_state::player_turn::White : game_state::player_turn::Black;
+
+    const auto pos = info.king_pos;
+
+    auto targets = attacks::king_attacks(pos) & mode_targets<Mode, Us>(board);
+
+    if (board.tracks_attacks()) {
+        // The maps are built with the king on the board, where it hides the squares behind it from a checking
+        // slider. Those squares stay on the checking line, so the whole line is ruled out
+        targets &= ~board.attacked_by(them);
+
+        const auto leapers = board.pieces(piece_t::type_t::Pawn) | board.pieces(piece_t::type_t::Knight);
+        for (auto sliders = info.checkers & ~leapers; sliders != bitboard::empty;) {
+            const auto checker = bitboard::pop_lsb(sliders);
+            targets &= ~(tables::line[pos][checker] ^ bitboard::square(checker));
+        }
+        add_moves<Us>(board, pos, targets, moves);
+    } else {
+        // The king is lifted off the board so it cannot hide behind itself on a checking ray
+        const auto occupancy_without_king = board.occupancy() ^ bitboard::square(pos);
+
+        while (targets != bitboard::empty) {
+            const move_t to = bitboard::pop_lsb(targets);
+            if (attackers_to<them>(board, to, occupancy_without_king) == bitboard::empty) {
+                add_moves<Us>(board, pos, bitboard::square(to), moves);
             }
+        }
+    }
 
-            move_t      pos = rank_file_to_position(r, f);
-            const auto& piece = board[pos];
+    // Castling: never out of check, through an attacked square or past a piece
+    if constexpr (Mode == gen_mode::Captures || Mode == gen_mode::Evasions) {
+        return;
+    }
 
-            if (piece.get_type() != piece_t::type_t::Empty) {
-                if ((piece.get_type() == piece_t::type_t::Bishop || piece.get_type() == piece_t::type_t::Queen) &&
-                    piece.get_color() == attacker_color) {
-                    return true;
-                }
-                break;  // Blocked by another piece
+    constexpr move_t home = is_white ? 60 : 4;
+    if (info.checkers != bitboard::empty || pos != home) {
+        return;
+    }
+
+    const auto occupancy = board.occupancy();
+    const auto can_castle_with = [&](move_t rook_pos, bitboard_t empty_path, bitboard_t king_path) {
+        if (board[rook_pos] != piece_t{piece_t::type_t::Rook, Us} || (occupancy & empty_path) != bitboard::empty) {
+            return false;
+        }
+
+        // Never in check here, so no ray runs through the king and the attack maps can be used as they are
+        if (board.tracks_attacks()) {
+            return (king_path & board.attacked_by(them)) == bitboard::empty;
+        }
+
+        while (king_path != bitboard::empty) {
+            if (attackers_to<them>(board, bitboard::pop_lsb(king_path), occupancy) != bitboard::empty) {
+                return false;
             }
         }
+        return true;
+    };
+
+    constexpr auto kingside_path = bitboard::square(home + 1) | bitboard::square(home + 2);
+    if (state.can_castle_kingside(player) && can_castle_with(home + 3, kingside_path, kingside_path)) {
+        moves.push_back({.from = pos, .to = home + 2, .type = move_type_flag::Castling});
     }
 
-    return false;
+    constexpr auto queenside_path = bitboard::square(home - 1) | bitboard::square(home - 2);
+    if (state.can_castle_queenside(player) &&
+        can_castle_with(home - 4, queenside_path | bitboard::square(home - 3), queenside_path)) {
+        moves.push_back({.from = pos, .to = home - 2, .type = move_type_flag::Castling});
+    }
+}
+
+template <piece_t::color_t Color>
+bitboard_t move_generator::attackers_to(const board_t& board, move_t square, bitboard_t occupancy)
+{
+    const auto queens = board.pieces(piece_t::type_t::Queen);
+
+    // A pawn of 'Color' attacks the square iff a pawn of the other color on the square would attack the pawn
+    const auto attackers =
+        (attacks::pawn_attacks(opposite(Color), square) & board.pieces(piece_t::type_t::Pawn)) |
+        (attacks::knight_attacks(square) & board.pieces(piece_t::type_t::Knight)) |
+        (attacks::king_attacks(square) & board.pieces(piece_t::type_t::King)) |
+        (attacks::rook_attacks(square, occupancy) & (board.pieces(piece_t::type_t::Rook) | queens)) |
+        (attacks::bishop_attacks(square, occupancy) & (board.pieces(piece_t::type_t::Bishop) | queens));
+
+    return attackers & board.pieces(Color);
 }
 
 bool move_generator::has_legal_moves(const board_t& board, const game_state& state)
 {
-    const auto player_turn = state.get_player_turn();
-    const auto piece_color =
-        (player_turn == game_state::player_turn::White) ? piece_t::color_t::White : piece_t::color_t::Black;
-
-    for (move_t pos = 0; pos < config::board::size * config::board::size; ++pos) {
-        const auto& piece = board[pos];
-        if (piece.get_type() != piece_t::type_t::Empty && piece.get_color() == piece_color) {
-            auto legal_moves = get_legal_moves(board, state, pos);
-            if (!legal_moves.empty()) {
-                return true;
-            }
-        }
-    }
+    move_list legal_moves;
+    generate_all(board, state, legal_moves);
 
-    return false;
+    return !legal_moves.empty();
 }
 
 }  // namespace chessfml
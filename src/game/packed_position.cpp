@@ -0,0 +1,68 @@
+#include "game/packed_position.hpp"
+
+#include "game/moves.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace chessfml {
+
+namespace {
+
+constexpr std::uint8_t black_bit = 0x08;
+constexpr std::uint8_t type_mask = 0x07;
+
+std::uint8_t pack_piece(const piece_t& piece) noexcept
+{
+    const auto code = static_cast<std::uint8_t>(std::to_underlying(piece.get_type()));
+    return piece.get_color() == piece_t::color_t::Black ? code | black_bit : code;
+}
+
+}  // namespace
+
+packed_position pack_position(const board_t& board, const game_state& state) noexcept
+{
+    packed_position packed{};
+
+    for (auto occupied = board.occupancy(); occupied != bitboard::empty;) {
+        const auto pos = bitboard::pop_lsb(occupied);
+        packed.squares[pos / 2] |= static_cast<std::uint8_t>(pack_piece(board[pos]) << (pos % 2 * 4));
+    }
+
+    const bool black_to_move = state.get_player_turn() == game_state::player_turn::Black;
+    packed.flags = static_cast<std::uint8_t>((black_to_move ? 1 : 0) | (state.get_castling_rights() << 1));
+
+    packed.en_passant = state.get_en_passant_target().value_or(packed_position::no_en_passant);
+    packed.halfmove_clock = static_cast<std::uint8_t>(std::clamp(state.get_halfmove_clock(), 0, 255));
+    packed.fullmove_number = static_cast<std::uint16_t>(std::clamp(state.get_fullmove_number(), 1, 0xFFFF));
+
+    return packed;
+}
+
+void unpack_position(const packed_position& packed, board_t& board, game_state& state) noexcept
+{
+    board.clear();
+
+    for (move_t pos = 0; pos < 64; ++pos) {
+        const auto code = static_cast<std::uint8_t>((packed.squares[pos / 2] >> (pos % 2 * 4)) & 0x0F);
+        if ((code & type_mask) == 0) {
+            continue;
+        }
+
+        const auto color = (code & black_bit) != 0 ? piece_t::color_t::Black : piece_t::color_t::White;
+        board.set_piece(pos, piece_t{static_cast<piece_t::type_t>(code & type_mask), color});
+    }
+
+    const bool black_to_move = (packed.flags & 0x01) != 0;
+    state.set_player_turn(black_to_move ? game_state::player_turn::Black : game_state::player_turn::White);
+    state.set_castling_rights(static_cast<std::uint8_t>((packed.flags >> 1) & 0x0F));
+
+    state.set_en_passant_target(packed.en_passant == packed_position::no_en_passant
+                                    ? std::nullopt
+                                    : std::optional<move_t>{packed.en_passant});
+    state.set_halfmove_clock(packed.halfmove_clock);
+    state.set_fullmove_number(packed.fullmove_number);
+    state.set_check(move_generator::is_in_check(board, state.get_player_turn()));
+}
+
+}  // namespace chessfml
@@ -0,0 +1,31 @@
+#include "game/zobrist.hpp"
+
+#include "game/board.hpp"
+#include "game/game_state.hpp"
+
+namespace chessfml::zobrist {
+
+zobrist_t compute(const board_t& board, const game_state& state) noexcept
+{
+    zobrist_t key = 0;
+
+    for (auto occupied = board.occupancy(); occupied != bitboard::empty;) {
+        const auto  pos = bitboard::pop_lsb(occupied);
+        const auto& piece = board[pos];
+        key ^= piece_key(piece.get_color(), piece.get_type(), pos);
+    }
+
+    if (state.get_player_turn() == game_state::player_turn::Black) {
+        key ^= keys.black_to_move;
+    }
+
+    key ^= castling_key(state.get_castling_rights());
+
+    if (can_capture_en_passant(board, state)) {
+        key ^= en_passant_key(*state.get_en_passant_target());
+    }
+
+    return key;
+}
+
+}  // namespace chessfml::zobrist
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <array>
+#include <utility>
+
+#include "common/bitboard.hpp"
+#include "common/utils.hpp"
+
+// Occupancy-independent attack and ray masks, all generated at compile time
+namespace chessfml::tables {
+
+using square_table = std::array<bitboard_t, 64>;
+using pair_table = std::array<square_table, 64>;
+
+namespace detail {
+
+constexpr std::array<std::pair<int, int>, 8> knight_offsets = {
+    {{-2, -1}, {-2, 1}, {-1, -2}, {-1, 2}, {1, -2}, {1, 2}, {2, -1}, {2, 1}}};
+
+// Also the eight ray directions of the queen
+constexpr std::array<std::pair<int, int>, 8> king_offsets = {
+    {{-1, -1}, {-1, 0}, {-1, 1}, {0, -1}, {0, 1}, {1, -1}, {1, 0}, {1, 1}}};
+
+// White pawns move towards rank index 0, so they capture one row up the array
+constexpr std::array<std::pair<int, int>, 2> white_pawn_offsets = {{{-1, -1}, {-1, 1}}};
+constexpr std::array<std::pair<int, int>, 2> black_pawn_offsets = {{{1, -1}, {1, 1}}};
+
+constexpr bool on_board(int rank, int file) noexcept
+{
+    return rank >= 0 && rank < config::board::size && file >= 0 && file < config::board::size;
+}
+
+template <std::size_t N>
+constexpr square_table leaper_table(const std::array<std::pair<int, int>, N>& offsets) noexcept
+{
+    square_table table{};
+
+    for (move_t pos = 0; pos < table.size(); ++pos) {
+        const auto [rank, file] = position_to_rank_file(pos);
+
+        for (const auto& [dr, df] : offsets) {
+            if (on_board(rank + dr, file + df)) {
+                table[pos] |= bitboard::square(rank_file_to_position(rank + dr, file + df));
+            }
+        }
+    }
+
+    return table;
+}
+
+// Walks every ray from every square once. Each square reached is given the squares passed so far when
+// 'full_lines' is false (between), or the whole line through both squares, edge to edge, when it is true (line)
+constexpr pair_table ray_table(bool full_lines) noexcept
+{
+    pair_table table{};
+
+    for (move_t from = 0; from < table.size(); ++from) {
+        const auto [rank, file] = position_to_rank_file(from);
+
+        for (const auto& [dr, df] : king_offsets) {
+            bitboard_t full_line = bitboard::square(from);
+            for (int i = 1; on_board(rank + dr * i, file + df * i); ++i) {
+                full_line |= bitboard::square(rank_file_to_position(rank + dr * i, file + df * i));
+            }
+            for (int i = 1; on_board(rank - dr * i, file - df * i); ++i) {
+                full_line |= bitboard::square(rank_file_to_position(rank - dr * i, file - df * i));
+            }
+
+            bitboard_t passed = bitboard::empty;
+            for (int i = 1; on_board(rank + dr * i, file + df * i); ++i) {
+                const move_t to = rank_file_to_position(rank + dr * i, file + df * i);
+                table[from][to] = full_lines ? full_line : passed;
+                passed |= bitboard::square(to);
+            }
+        }
+    }
+
+    return table;
+}
+
+}  // namespace detail
+
+inline constexpr square_table knight_attacks = detail::leaper_table(detail::knight_offsets);
+inline constexpr square_table king_attacks = detail::leaper_table(detail::king_offsets);
+
+// Indexed by piece_t::color_t, then by the square the pawn stands on
+inline constexpr std::array<square_table, 2> pawn_attacks = {detail::leaper_table(detail::white_pawn_offsets),
+                                                             detail::leaper_table(detail::black_pawn_offsets)};
+
+// Squares strictly between two squares sharing a rank, file or diagonal, empty otherwise
+inline constexpr pair_table between = detail::ray_table(false);
+
+// The full rank, file or diagonal through two aligned squares, both included, empty otherwise
+inline constexpr pair_table line = detail::ray_table(true);
+
+}  // namespace chessfml::tables
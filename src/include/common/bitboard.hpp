@@ -0,0 +1,49 @@
+#pragma once
+
+#include <bit>
+#include <cstdint>
+
+#include "common/config.hpp"
+
+namespace chessfml {
+
+// One bit per square, using the same indexing as board_t (bit 0 = a8, bit 63 = h1)
+using bitboard_t = std::uint64_t;
+
+namespace bitboard {
+
+constexpr bitboard_t empty{0ULL};
+constexpr bitboard_t full{~0ULL};
+
+constexpr bitboard_t square(move_t pos) noexcept
+{
+    return bitboard_t{1} << pos;
+}
+
+constexpr bool test(bitboard_t bb, move_t pos) noexcept
+{
+    return (bb & square(pos)) != 0;
+}
+
+constexpr int count(bitboard_t bb) noexcept
+{
+    return std::popcount(bb);
+}
+
+// Undefined for an empty bitboard
+constexpr move_t lsb(bitboard_t bb) noexcept
+{
+    return static_cast<move_t>(std::countr_zero(bb));
+}
+
+// Returns the lowest set square and clears it from the bitboard
+constexpr move_t pop_lsb(bitboard_t& bb) noexcept
+{
+    const auto pos = lsb(bb);
+    bb &= bb - 1;
+    return pos;
+}
+
+}  // namespace bitboard
+
+}  // namespace chessfml
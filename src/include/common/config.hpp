@@ -1,6 +1,5 @@
 #pragma once
 
-#include <SFML/Graphics.hpp>
 #include <cstdint>
 #include <string_view>
 
@@ -34,11 +33,15 @@ struct board
 
     static constexpr auto tile_size_ui{size_ui / 8.0f};
 
-    static constexpr std::array<sf::Color, 2> tile_colors{sf::Color{240, 217, 181}, sf::Color{181, 136, 99}};
-
     static constexpr auto size{8};
 
     static constexpr std::string_view fen_starting_position{"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1"};
 };
 
+struct engine
+{
+    // Transposition table of the AI, allocated once per game. Bigger keeps more of a long think between moves
+    static constexpr auto hash_size_mb{64u};
+};
+
 }  // namespace chessfml::config
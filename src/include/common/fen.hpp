@@ -3,6 +3,7 @@
 #include <optional>
 #include <string>
 #include <string_view>
+#include <vector>
 #include "game/board.hpp"
 #include "game/game_state.hpp"
 
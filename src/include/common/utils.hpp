@@ -1,5 +1,6 @@
 #pragma once
 
+#include <string>
 #include <utility>
 #include "common/config.hpp"
 
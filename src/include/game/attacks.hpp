@@ -0,0 +1,59 @@
+#pragma once
+
+#include "common/attack_tables.hpp"
+#include "common/bitboard.hpp"
+#include "game/piece.hpp"
+
+#include <utility>
+
+namespace chessfml::attacks {
+
+// Slider lookup backend picked once at startup: PEXT indexing when the CPU has fast BMI2, magic multiply otherwise
+enum class backend { Magic, Pext };
+
+[[nodiscard]] backend active_backend() noexcept;
+
+// Slider attacks from 'pos' given the board occupancy. The attack set includes the first blocker in each
+// direction, whichever color it is. Backed by magic-bitboard (or PEXT) tables built on the first call.
+[[nodiscard]] bitboard_t rook_attacks(move_t pos, bitboard_t occupancy) noexcept;
+[[nodiscard]] bitboard_t bishop_attacks(move_t pos, bitboard_t occupancy) noexcept;
+
+[[nodiscard]] inline bitboard_t queen_attacks(move_t pos, bitboard_t occupancy) noexcept
+{
+    return rook_attacks(pos, occupancy) | bishop_attacks(pos, occupancy);
+}
+
+// Leaper attacks, independent of occupancy: plain loads from the compile-time tables
+[[nodiscard]] inline bitboard_t knight_attacks(move_t pos) noexcept
+{
+    return tables::knight_attacks[pos];
+}
+
+[[nodiscard]] inline bitboard_t king_attacks(move_t pos) noexcept
+{
+    return tables::king_attacks[pos];
+}
+
+// Squares a pawn of 'color' standing on 'pos' captures on
+[[nodiscard]] inline bitboard_t pawn_attacks(piece_t::color_t color, move_t pos) noexcept
+{
+    return tables::pawn_attacks[std::to_underlying(color)][pos];
+}
+
+// Attack set of a knight or slider chosen at compile time, so per-type generation loops share one body
+template <piece_t::type_t Type>
+[[nodiscard]] inline bitboard_t piece_attacks(move_t pos, bitboard_t occupancy) noexcept
+{
+    if constexpr (Type == piece_t::type_t::Knight) {
+        return knight_attacks(pos);
+    } else if constexpr (Type == piece_t::type_t::Bishop) {
+        return bishop_attacks(pos, occupancy);
+    } else if constexpr (Type == piece_t::type_t::Rook) {
+        return rook_attacks(pos, occupancy);
+    } else {
+        static_assert(Type == piece_t::type_t::Queen, "pawns and kings have their own generators");
+        return queen_attacks(pos, occupancy);
+    }
+}
+
+}  // namespace chessfml::attacks
@@ -1,13 +1,34 @@
 #pragma once
 
+#include "common/attack_tables.hpp"
+#include "common/bitboard.hpp"
+#include "game/game_state.hpp"
+#include "game/move.hpp"
 #include "game/piece.hpp"
+#include "game/zobrist.hpp"
 
 #include <array>
 #include <expected>
+#include <utility>
 
 namespace chessfml {
 
 enum class fen_error { InvalidCharacter, InvalidFormat };
+
+// Everything make_move overwrites that cannot be recomputed from the move itself
+struct undo_info
+{
+    move_info             move;
+    piece_t               moved;     // The piece as it stood on 'from', before promotion
+    piece_t               captured;  // Empty when nothing was captured
+    move_t                captured_pos;
+    std::uint8_t          castling_rights;
+    std::optional<move_t> en_passant_target;
+    int                   halfmove_clock;
+    int                   fullmove_number;
+    bool                  in_check;
+};
+
 class board_t
 {
 public:
@@ -20,14 +41,88 @@ public:
     // auto cbegin() const { return m_board.cbegin(); }
     // auto cend() const { return m_board.cend(); }
 
-    template <typename Self>
-    auto&& operator[](this Self&& self, std::size_t idx)
+    // Read-only: every write goes through the mutators below so the bitboards stay in sync with the mailbox
+    const piece_t& operator[](std::size_t idx) const noexcept { return m_board[idx]; }
+
+    void set_piece(move_t pos, piece_t piece) noexcept;
+    void remove_piece(move_t pos) noexcept;
+    void move_piece(move_t from, move_t to) noexcept;  // Captures whatever stands on 'to'
+    void clear() noexcept;
+
+    // Plays a move in place, including castling, en passant and promotion, and updates the castling rights,
+    // en passant target, move counters and side to move of 'state'. The check flag is left to the caller.
+    // unmake_move restores both the board and the state from the returned record.
+    [[nodiscard]] undo_info make_move(const move_info& move, game_state& state) noexcept;
+    void                    unmake_move(const undo_info& undo, game_state& state) noexcept;
+
+    bitboard_t pieces(piece_t::color_t color) const noexcept { return m_color_bb[std::to_underlying(color)]; }
+    bitboard_t pieces(piece_t::type_t type) const noexcept { return m_type_bb[std::to_underlying(type)]; }
+    bitboard_t pieces(piece_t::type_t type, piece_t::color_t color) const noexcept
     {
-        return std::forward<Self>(self).m_board[idx];
+        return pieces(type) & pieces(color);
+    }
+
+    bitboard_t occupancy() const noexcept { return m_color_bb[0] | m_color_bb[1]; }
+    bool       is_empty(move_t pos) const noexcept { return !bitboard::test(occupancy(), pos); }
+
+    // Zobrist key of the pieces alone, kept up to date by the mutators. See position_key for the full key
+    zobrist_t key() const noexcept { return m_key; }
+
+    // Square of the king of 'color', or no_square when that king is missing (editor or broken FEN positions)
+    static constexpr move_t no_square = 0xFF;
+    move_t king_square(piece_t::color_t color) const noexcept { return m_king_pos[std::to_underlying(color)]; }
+
+    // Optional per-color attack maps, kept in sync by every mutator while enabled. Off by default: the upkeep
+    // costs more than it saves in make/unmake-heavy loops, but turns attack queries into a single bit test
+    void set_attack_tracking(bool enabled) noexcept;
+    bool tracks_attacks() const noexcept { return m_track_attacks; }
+
+    // Squares attacked by 'color' with the board as it stands, so a king still blocks the rays behind it.
+    // Only valid while attack tracking is enabled
+    bitboard_t attacked_by(piece_t::color_t color) const noexcept { return m_attacked[std::to_underlying(color)]; }
+    int        attacker_count(move_t pos, piece_t::color_t color) const noexcept
+    {
+        return m_attack_counts[std::to_underlying(color)][pos];
     }
 
 private:
-    std::array<piece_t, 64> m_board;
+    bitboard_t piece_attacks(move_t pos) const noexcept;
+    bitboard_t sliders_through(move_t pos) const noexcept;
+    void       update_attacks(bitboard_t pieces, int delta) noexcept;
+
+    std::array<piece_t, 64>   m_board{};
+    std::array<bitboard_t, 7> m_type_bb{};   // Indexed by piece_t::type_t, Empty slot unused
+    std::array<bitboard_t, 2> m_color_bb{};  // Indexed by piece_t::color_t
+    std::array<move_t, 2>     m_king_pos{no_square, no_square};  // Indexed by piece_t::color_t
+    zobrist_t                 m_key{0};
+
+    std::array<std::array<std::uint8_t, 64>, 2> m_attack_counts{};  // Attackers per color and square
+    std::array<bitboard_t, 2>                   m_attacked{};       // Squares with a non-zero count
+    bool                                        m_track_attacks{false};
 };
 
+// Whether a pawn of the side to move stands next to the en passant target. Without one the target changes nothing
+// that can be played, so the position is the same as without it
+[[nodiscard]] inline bool can_capture_en_passant(const board_t& board, const game_state& state) noexcept
+{
+    const auto target = state.get_en_passant_target();
+    if (!target) {
+        return false;
+    }
+
+    const auto us = state.get_player_turn() == game_state::player_turn::White ? piece_t::color_t::White
+                                                                               : piece_t::color_t::Black;
+
+    // The squares a pawn of ours could take from are those an enemy pawn on the target would attack
+    const auto from = tables::pawn_attacks[std::to_underlying(opposite(us))][*target];
+    return (from & board.pieces(piece_t::type_t::Pawn, us)) != bitboard::empty;
+}
+
+// Full Zobrist key of the position: pieces from the board, side to move, castling and en passant from the state
+inline zobrist_t position_key(const board_t& board, const game_state& state) noexcept
+{
+    const auto key = board.key() ^ state.key();
+    return can_capture_en_passant(board, state) ? key ^ zobrist::en_passant_key(*state.get_en_passant_target()) : key;
+}
+
 }  // namespace chessfml
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "game/board.hpp"
+#include "game/piece.hpp"
+
+namespace chessfml::engine {
+
+// Centipawns, always from the point of view of the side the score is given to
+using score_t = std::int32_t;
+
+// Indexed by piece_t::type_t. The king is never traded, so it carries no material
+inline constexpr std::array<score_t, 7> piece_values = {0, 100, 500, 320, 330, 900, 0};
+
+// Material and piece-square tables, positive when 'side' stands better. The king's table slides from the
+// middlegame one to the endgame one as the pieces come off
+[[nodiscard]] score_t evaluate(const board_t& board, piece_t::color_t side) noexcept;
+
+}  // namespace chessfml::engine
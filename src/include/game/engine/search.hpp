@@ -0,0 +1,156 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "game/board.hpp"
+#include "game/engine/evaluate.hpp"
+#include "game/engine/time_manager.hpp"
+#include "game/engine/transposition_table.hpp"
+#include "game/game_state.hpp"
+#include "game/key_history.hpp"
+#include "game/move.hpp"
+#include "game/moves.hpp"
+
+namespace chessfml::engine {
+
+inline constexpr int max_ply = 128;
+
+// Being mated 'n' plies from the root scores -(mate_score - n), so shorter mates are preferred and longer
+// defences chosen when losing. Anything within max_ply of mate_score is a mate score
+inline constexpr score_t mate_score = 32000;
+inline constexpr score_t infinite_score = mate_score + 1;
+inline constexpr score_t draw_score = 0;
+
+[[nodiscard]] constexpr bool is_mate_score(score_t score) noexcept
+{
+    return score >= mate_score - max_ply || score <= -(mate_score - max_ply);
+}
+
+// Full moves until mate: positive when the side to move mates, negative when it gets mated
+[[nodiscard]] constexpr int mate_in(score_t score) noexcept
+{
+    return score > 0 ? (mate_score - score + 1) / 2 : -(mate_score + score) / 2;
+}
+
+// A zero leaves a limit out. With neither a move time nor a clock the search runs to 'depth', bounded by 'nodes'
+// when set. The clock is the one of the side to move
+struct search_limits
+{
+    int                       depth{max_ply - 1};
+    std::uint64_t             nodes{0};
+    std::chrono::milliseconds move_time{0};  // Spend exactly this long
+    std::chrono::milliseconds time_left{0};  // Or budget the move from the remaining clock
+    std::chrono::milliseconds increment{0};
+    int                       moves_to_go{0};  // Moves until the clock is topped up, 0 when it never is
+};
+
+struct search_result
+{
+    std::optional<move_info> best_move;  // Empty when the side to move has no legal move
+    score_t                  score{0};
+    int                      depth{0};  // Last fully searched depth, the one the move and score come from
+    std::uint64_t            nodes{0};
+    std::vector<move_info>   pv;  // Principal variation, starting with best_move
+};
+
+// Negamax alpha-beta over the legal move generator, deepened one ply at a time so an interrupted search still
+// has the previous depth's answer, and under a clock time_manager decides when to stop deepening. Leaves are
+// resolved by a captures-only quiescence search. Each thread of a search runs one worker, on its own copy of
+// the position and its own PV and killers, over the transposition table they all share
+class search_worker
+{
+public:
+    // Worker 0 runs on the main thread, the others are helpers
+    search_worker(int index, transposition_table& tt, const std::atomic<bool>& stop) noexcept
+        : m_index(index), m_tt(tt), m_stop(stop)
+    {}
+
+    search_result search(const board_t&       board,
+                         const game_state&    state,
+                         const key_history&   history,
+                         const search_limits& limits);
+
+    [[nodiscard]] std::uint64_t nodes() const noexcept { return m_nodes; }
+
+private:
+    score_t negamax(int depth, int ply, score_t alpha, score_t beta);
+    score_t quiescence(int ply, score_t alpha, score_t beta);
+    void    update_pv(int ply, const move_info& move) noexcept;
+
+    // Scores every move for ordering; pick_next then moves the best remaining one to 'index'
+    void order_moves(move_list&                            moves,
+                     int                                   ply,
+                     packed_move                           tt_move,
+                     std::array<int, move_list::capacity>& scores) const;
+    void pick_next(move_list& moves, std::array<int, move_list::capacity>& scores, std::size_t index) const;
+
+    bool should_stop() noexcept;
+    void make(const move_info& move);
+    void unmake();
+
+    int                      m_index;
+    transposition_table&     m_tt;
+    const std::atomic<bool>& m_stop;
+
+    board_t                m_board;
+    game_state             m_state;
+    key_history            m_history;
+    std::vector<undo_info> m_undo;
+    search_limits          m_limits;
+    time_manager           m_time;
+
+    std::uint64_t m_nodes{0};
+    bool          m_has_searched_move{false};  // The clock is not read before the first iteration completed
+    bool          m_aborted{false};
+
+    // Triangular PV table: row 'ply' holds the best line found from that ply, m_pv_length[ply] entries long
+    std::array<std::array<move_info, max_ply>, max_ply> m_pv{};
+    std::array<int, max_ply>                            m_pv_length{};
+    std::vector<move_info>                              m_previous_pv;  // Tried first in the next iteration
+
+    // Two quiet moves per ply that caused a cutoff, tried right after the captures at the same ply elsewhere
+    std::array<std::array<std::optional<move_info>, 2>, max_ply> m_killers{};
+};
+
+// Lazy SMP: every thread searches the same root with nothing shared but the transposition table, so the helpers
+// only make the main thread faster by filling it with results it would otherwise search itself. The main thread
+// runs on the caller's, the helpers are started per search and stopped as soon as it returns. The table is kept
+// from one search to the next
+class searcher
+{
+public:
+    explicit searcher(std::size_t hash_size_mb = transposition_table::default_size_mb) : m_tt(hash_size_mb)
+    {
+        set_threads(1);
+    }
+
+    // Neither while a search is running
+    void set_hash_size(std::size_t size_mb) { m_tt.resize(size_mb); }
+    void set_threads(std::size_t threads);
+    void clear_hash() noexcept { m_tt.clear(); }
+
+    [[nodiscard]] std::size_t threads() const noexcept { return m_workers.size(); }
+
+    // The main thread's answer, with the nodes of all threads
+    search_result search(const board_t&       board,
+                         const game_state&    state,
+                         const key_history&   history,
+                         const search_limits& limits);
+
+    // Makes a running search, or the next one if none is, return its last completed depth as soon as possible.
+    // Safe from any thread
+    void stop() noexcept { m_stop.store(true, std::memory_order_relaxed); }
+
+private:
+    transposition_table                         m_tt;
+    std::atomic<bool>                           m_stop{false};
+    std::vector<std::unique_ptr<search_worker>> m_workers;  // Boxed, a worker is large and refers to m_stop
+};
+
+}  // namespace chessfml::engine
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <chrono>
+
+#include "game/move.hpp"
+
+namespace chessfml::engine {
+
+struct search_limits;
+
+// Turns the limits of one search into two deadlines. The soft one is checked between iterations and shrinks
+// while the best move stays the same; the hard one is polled inside the search and aborts it. Both are measured
+// from construction, which should be when the move was requested
+class time_manager
+{
+public:
+    using clock = std::chrono::steady_clock;
+
+    time_manager() = default;
+    explicit time_manager(const search_limits& limits);
+
+    [[nodiscard]] bool is_enabled() const noexcept { return m_enabled; }
+
+    // Records the best move of an iteration that just completed
+    void on_iteration(const move_info& best_move) noexcept;
+
+    // After an iteration: another depth would very likely run past the budget or not change the move
+    [[nodiscard]] bool should_stop_deepening() const noexcept;
+
+    // Inside the search: the move must be played now
+    [[nodiscard]] bool is_hard_limit_reached() const noexcept { return m_enabled && clock::now() >= m_hard_deadline; }
+
+    [[nodiscard]] clock::duration elapsed() const noexcept { return clock::now() - m_start; }
+    [[nodiscard]] clock::duration soft_limit() const noexcept { return m_soft_limit; }
+    [[nodiscard]] clock::duration hard_limit() const noexcept { return m_hard_limit; }
+
+private:
+    clock::time_point m_start{clock::now()};
+    clock::time_point m_hard_deadline;
+    clock::duration   m_soft_limit{};
+    clock::duration   m_hard_limit{};
+    bool              m_enabled{false};
+    bool              m_scale_with_stability{false};  // Only with a clock, a fixed move time is used up
+
+    move_info m_last_best{};
+    int       m_iterations{0};
+    int       m_stable_iterations{0};  // Iterations in a row that kept the same best move
+};
+
+}  // namespace chessfml::engine
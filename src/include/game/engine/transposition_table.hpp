@@ -0,0 +1,125 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "game/engine/evaluate.hpp"
+#include "game/move.hpp"
+#include "game/zobrist.hpp"
+
+namespace chessfml::engine {
+
+// What a stored score says about the true one: exact, at least it (the node failed high) or at most it (it
+// failed low)
+enum class bound_t : std::uint8_t { None, Exact, Lower, Upper };
+
+struct tt_hit
+{
+    packed_move move;  // Best or refuting move, zero when none was found
+    score_t     score;
+    int         depth;
+    bound_t     bound;
+};
+
+// Hash table of search results keyed by the Zobrist key. Entries are grouped in buckets of four that fill one
+// cache line, so a probe costs a single memory access. Within a bucket the entry replaced is the shallowest,
+// where every search an entry has sat unused costs it as much as 'age_weight' plies of depth.
+// Shared by the search threads without a lock: an entry is two relaxed 64-bit words, the data and the key XORed
+// with it. Two threads writing the same entry can leave a mix of both, whose key then no longer matches, so a
+// torn entry reads as a miss instead of another position's result
+class transposition_table
+{
+public:
+    static constexpr std::size_t default_size_mb = 16;
+
+    explicit transposition_table(std::size_t size_mb = default_size_mb) { resize(size_mb); }
+
+    // Rounded down to a power of two number of buckets. Drops every entry
+    void resize(std::size_t size_mb);
+    void clear() noexcept;
+
+    // Called once per search before the threads start, ages the entries of the previous ones
+    void new_search() noexcept { m_generation = (m_generation + 1) & generation_mask; }
+
+    // Starts loading the bucket of 'key', for a probe that will follow a little later
+    void prefetch(zobrist_t key) const noexcept
+    {
+#if defined(__GNUC__)
+        __builtin_prefetch(&m_buckets[index(key)]);
+#endif
+    }
+
+    [[nodiscard]] std::optional<tt_hit> probe(zobrist_t key) const noexcept;
+
+    // An entry already holding 'key' keeps its move when 'move' is empty, so a fail-low does not lose it
+    void store(zobrist_t key, int depth, score_t score, bound_t bound, packed_move move) noexcept;
+
+private:
+    static constexpr std::uint8_t generation_mask = 0x3F;
+    static constexpr int          age_weight = 8;
+
+    // Everything but the key, in one word. The bound sits in the low two bits of 'bound_generation', the search
+    // that wrote it above
+    struct entry_data
+    {
+        packed_move   move;
+        std::int16_t  score;
+        std::uint8_t  depth;
+        std::uint8_t  bound_generation;
+        std::uint16_t padding;
+
+        bound_t      bound() const noexcept { return static_cast<bound_t>(bound_generation & 0x03); }
+        std::uint8_t generation() const noexcept { return bound_generation >> 2; }
+    };
+
+    static_assert(sizeof(entry_data) == sizeof(std::uint64_t));
+
+    // An all zero entry is empty, its bound being None
+    struct entry
+    {
+        std::atomic<std::uint64_t> key_xor_data;
+        std::atomic<std::uint64_t> data;
+
+        entry_data load() const noexcept { return std::bit_cast<entry_data>(data.load(std::memory_order_relaxed)); }
+
+        // The key the entry was written for, or garbage when it is torn
+        zobrist_t key(const entry_data& d) const noexcept
+        {
+            return key_xor_data.load(std::memory_order_relaxed) ^ std::bit_cast<std::uint64_t>(d);
+        }
+
+        void save(zobrist_t key, const entry_data& d) noexcept
+        {
+            const auto raw = std::bit_cast<std::uint64_t>(d);
+            key_xor_data.store(key ^ raw, std::memory_order_relaxed);
+            data.store(raw, std::memory_order_relaxed);
+        }
+    };
+
+    static constexpr std::size_t bucket_size = 4;
+
+    struct alignas(64) bucket
+    {
+        std::array<entry, bucket_size> entries;
+    };
+
+    static_assert(sizeof(entry) == 16);
+    static_assert(sizeof(bucket) == 64);
+
+    std::size_t index(zobrist_t key) const noexcept { return key & m_mask; }
+
+    // How many searches ago the entry was written
+    int age(const entry_data& d) const noexcept { return (m_generation - d.generation()) & generation_mask; }
+
+    // Atomics can be neither copied nor moved, so the vector is only ever built at its size and cleared in place
+    std::vector<bucket> m_buckets;
+    std::size_t         m_mask{0};
+    std::uint8_t        m_generation{0};
+};
+
+}  // namespace chessfml::engine
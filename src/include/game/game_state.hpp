@@ -5,6 +5,7 @@
 #include <optional>
 
 #include "common/config.hpp"
+#include "game/zobrist.hpp"
 
 namespace chessfml {
 
@@ -16,9 +17,18 @@ public:
     game_state() = default;
 
     const player_turn& get_player_turn() const { return m_turn; }
-    void               set_player_turn(player_turn turn) noexcept { m_turn = turn; }
-
-    void next_turn() { m_turn = (m_turn == player_turn::White) ? player_turn::Black : player_turn::White; }
+    void               set_player_turn(player_turn turn) noexcept
+    {
+        if (turn != m_turn) {
+            next_turn();
+        }
+    }
+
+    void next_turn()
+    {
+        m_turn = (m_turn == player_turn::White) ? player_turn::Black : player_turn::White;
+        m_key ^= zobrist::keys.black_to_move;
+    }
 
     std::optional<move_t> get_en_passant_target() const { return m_en_passant_target; }
     void                  set_en_passant_target(std::optional<move_t> target) { m_en_passant_target = target; }
@@ -29,7 +39,19 @@ public:
     void disable_queenside_castling(player_turn player);
     void enable_kingside_castling(player_turn player) noexcept;
     void enable_queenside_castling(player_turn player) noexcept;
-    void clear_castling_rights() noexcept { m_castling_rights = 0x00; }
+    void clear_castling_rights() noexcept { set_castling_rights(0x00); }
+
+    // Raw castling flags, used to save and restore them around make/unmake
+    [[nodiscard]] std::uint8_t get_castling_rights() const noexcept { return m_castling_rights; }
+    void                       set_castling_rights(std::uint8_t rights) noexcept
+    {
+        m_key ^= zobrist::castling_key(m_castling_rights) ^ zobrist::castling_key(rights);
+        m_castling_rights = rights;
+    }
+
+    // Zobrist key of the side to move and castling rights, kept up to date by every setter. The pieces come from
+    // the board and whether the en passant file counts depends on them, see position_key
+    [[nodiscard]] zobrist_t key() const noexcept { return m_key; }
 
     bool is_check() const { return m_in_check; }
     void set_check(bool in_check) { m_in_check = in_check; }
@@ -37,6 +59,9 @@ public:
     [[nodiscard]] int get_halfmove_clock() const noexcept { return m_halfmove_clock; }
     void              set_halfmove_clock(int clock) noexcept { m_halfmove_clock = clock; }
 
+    // A hundred plies without a capture or a pawn move. Checkmate on the last of them still takes precedence
+    [[nodiscard]] bool is_fifty_move_draw() const noexcept { return m_halfmove_clock >= 100; }
+
     [[nodiscard]] int get_fullmove_number() const noexcept { return m_fullmove_number; }
     void              set_fullmove_number(int number) noexcept { m_fullmove_number = number; }
 
@@ -53,6 +78,8 @@ private:
     bool m_in_check{false};
     int  m_halfmove_clock{0};   // Number of halfmoves since last capture or pawn advance
     int  m_fullmove_number{1};  // Number of full moves, starts at 1 and increments after Black's move
+
+    zobrist_t m_key{zobrist::castling_key(0x0F)};  // Matches the defaults above
 };
 
 }  // namespace chessfml
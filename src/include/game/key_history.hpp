@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "game/zobrist.hpp"
+
+namespace chessfml {
+
+// Keys of the positions reached so far, oldest first, pushed after every move and popped on unmake. Used for
+// repetition detection by both the game and the search
+class key_history
+{
+public:
+    void push(zobrist_t key) { m_keys.push_back(key); }
+    void pop() noexcept { m_keys.pop_back(); }
+    void clear() noexcept { m_keys.clear(); }
+
+    [[nodiscard]] std::size_t size() const noexcept { return m_keys.size(); }
+    [[nodiscard]] bool        empty() const noexcept { return m_keys.empty(); }
+
+    // How many times the latest position occurred before. A capture or pawn move can never be undone, so only
+    // the last 'halfmove_clock' plies are scanned
+    [[nodiscard]] int repetitions(int halfmove_clock) const noexcept;
+
+    // The latest position is on the board for the third time
+    [[nodiscard]] bool is_threefold(int halfmove_clock) const noexcept { return repetitions(halfmove_clock) >= 2; }
+
+private:
+    std::vector<zobrist_t> m_keys;
+};
+
+}  // namespace chessfml
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <cstdint>
+#include "common/config.hpp"
+
+namespace chessfml {
+
+enum class move_type_flag : std::uint8_t {
+    Normal = 0,
+    Capture = 1 << 0,    // 0x01
+    EnPassant = 1 << 1,  // 0x02
+    Castling = 1 << 2,   // 0x04
+    Promotion = 1 << 3   // 0x08
+};
+
+constexpr move_type_flag operator|(move_type_flag a, move_type_flag b)
+{
+    return static_cast<move_type_flag>(static_cast<std::uint8_t>(a) | static_cast<std::uint8_t>(b));
+}
+
+constexpr move_type_flag operator&(move_type_flag a, move_type_flag b)
+{
+    return static_cast<move_type_flag>(static_cast<std::uint8_t>(a) & static_cast<std::uint8_t>(b));
+}
+
+constexpr bool has_flag(move_type_flag value, move_type_flag flag)
+{
+    return (static_cast<std::uint8_t>(value) & static_cast<std::uint8_t>(flag)) != 0;
+}
+
+// Kept trivial (no default member initializers) so move_list storage is not initialized on construction.
+// Members left out of a designated initializer are still zeroed: Normal and no promotion.
+struct move_info
+{
+    move_t         from;
+    move_t         to;
+    move_type_flag type;
+    std::uint8_t   promotion_piece;  // Corresponds to piece_t::type_t
+
+    constexpr bool operator==(const move_info& other) const noexcept { return from == other.from && to == other.to; }
+
+    constexpr bool is_capture() const noexcept { return has_flag(type, move_type_flag ::Capture); }
+    constexpr bool is_en_passant() const noexcept { return has_flag(type, move_type_flag ::EnPassant); }
+    constexpr bool is_castling() const noexcept { return has_flag(type, move_type_flag ::Castling); }
+    constexpr bool is_promotion() const noexcept { return has_flag(type, move_type_flag ::Promotion); }
+};
+
+// Move packed in 16 bits for storage (transposition tables, move history): from in bits 0-5, to in bits 6-11
+// and a 4-bit kind in bits 12-15. The kind folds the flags and the promotion piece together, since only a
+// handful of combinations can occur. move_info stays the working format of the generator
+class packed_move
+{
+public:
+    constexpr packed_move() noexcept = default;
+    constexpr explicit packed_move(const move_info& move) noexcept
+        : m_data(static_cast<std::uint16_t>(move.from | (move.to << 6) | (kind_of(move) << 12)))
+    {}
+
+    constexpr move_t        from() const noexcept { return m_data & 0x3F; }
+    constexpr move_t        to() const noexcept { return (m_data >> 6) & 0x3F; }
+    constexpr std::uint16_t raw() const noexcept { return m_data; }
+
+    // Reverses the constructor exactly, flags and promotion piece included
+    constexpr move_info unpack() const noexcept
+    {
+        const auto kind = static_cast<std::uint8_t>(m_data >> 12);
+
+        move_info move{.from = from(), .to = to(), .type = move_type_flag::Normal, .promotion_piece = 0};
+        if (kind >= promotion) {
+            move.type = move_type_flag::Promotion;
+            if (kind >= capture_promotion) {
+                move.type = move.type | move_type_flag::Capture;
+            }
+            move.promotion_piece = static_cast<std::uint8_t>(first_promotion_piece + (kind & 0x03));
+        } else if (kind == capture) {
+            move.type = move_type_flag::Capture;
+        } else if (kind == en_passant) {
+            move.type = move_type_flag::Capture | move_type_flag::EnPassant;
+        } else if (kind == castling) {
+            move.type = move_type_flag::Castling;
+        }
+        return move;
+    }
+
+    constexpr bool operator==(const packed_move&) const noexcept = default;
+
+private:
+    // Kinds 4-7 and 8-11 are the quiet and capturing promotions, in piece_t::type_t order from Rook to Queen
+    static constexpr std::uint8_t quiet = 0;
+    static constexpr std::uint8_t capture = 1;
+    static constexpr std::uint8_t en_passant = 2;
+    static constexpr std::uint8_t castling = 3;
+    static constexpr std::uint8_t promotion = 4;
+    static constexpr std::uint8_t capture_promotion = 8;
+
+    static constexpr std::uint8_t first_promotion_piece = 2;  // piece_t::type_t::Rook
+
+    static constexpr std::uint8_t kind_of(const move_info& move) noexcept
+    {
+        if (move.is_promotion()) {
+            const auto piece = static_cast<std::uint8_t>((move.promotion_piece - first_promotion_piece) & 0x03);
+            return static_cast<std::uint8_t>((move.is_capture() ? capture_promotion : promotion) + piece);
+        }
+        if (move.is_en_passant()) {
+            return en_passant;
+        }
+        if (move.is_castling()) {
+            return castling;
+        }
+        return move.is_capture() ? capture : quiet;
+    }
+
+    std::uint16_t m_data{0};
+};
+
+static_assert(sizeof(packed_move) == 2);
+
+}  // namespace chessfml
@@ -1,47 +1,53 @@
 #pragma once
+#include <array>
 #include <vector>
 #include "common/config.hpp"
 #include "game/board.hpp"
 #include "game/game_state.hpp"
+#include "game/move.hpp"
 
 namespace chessfml {
 
-enum class move_type_flag : std::uint8_t {
-    Normal = 0,
-    Capture = 1 << 0,    // 0x01
-    EnPassant = 1 << 1,  // 0x02
-    Castling = 1 << 2,   // 0x04
-    Promotion = 1 << 3   // 0x08
-};
-
-constexpr move_type_flag operator|(move_type_flag a, move_type_flag b)
+// Fixed-capacity move container living on the stack, so generating moves never touches the heap.
+// No legal chess position has more than 218 moves, 256 leaves room for pseudo-legal ones.
+class move_list
 {
-    return static_cast<move_type_flag>(static_cast<std::uint8_t>(a) | static_cast<std::uint8_t>(b));
-}
+public:
+    static constexpr std::size_t capacity{256};
 
-constexpr move_type_flag operator&(move_type_flag a, move_type_flag b)
-{
-    return static_cast<move_type_flag>(static_cast<std::uint8_t>(a) & static_cast<std::uint8_t>(b));
-}
+    void push_back(const move_info& move) noexcept { m_moves[m_size++] = move; }
+    void clear() noexcept { m_size = 0; }
 
-constexpr bool has_flag(move_type_flag value, move_type_flag flag)
-{
-    return (static_cast<std::uint8_t>(value) & static_cast<std::uint8_t>(flag)) != 0;
-}
+    std::size_t size() const noexcept { return m_size; }
+    bool        empty() const noexcept { return m_size == 0; }
 
-struct move_info
-{
-    move_t         from;
-    move_t         to;
-    move_type_flag type{move_type_flag ::Normal};
-    std::uint8_t   promotion_piece{0};  // Corresponds to piece_t::type_t
+    auto begin() noexcept { return m_moves.begin(); }
+    auto end() noexcept { return m_moves.begin() + m_size; }
+    auto begin() const noexcept { return m_moves.begin(); }
+    auto end() const noexcept { return m_moves.begin() + m_size; }
 
-    constexpr bool operator==(const move_info& other) const noexcept { return from == other.from && to == other.to; }
+    move_info&       operator[](std::size_t idx) noexcept { return m_moves[idx]; }
+    const move_info& operator[](std::size_t idx) const noexcept { return m_moves[idx]; }
 
-    bool is_capture() const noexcept { return has_flag(type, move_type_flag ::Capture); }
-    bool is_en_passant() const noexcept { return has_flag(type, move_type_flag ::EnPassant); }
-    bool is_castling() const noexcept { return has_flag(type, move_type_flag ::Castling); }
-    bool is_promotion() const noexcept { return has_flag(type, move_type_flag ::Promotion); }
+private:
+    std::array<move_info, capacity> m_moves;
+    std::size_t                     m_size{0};
+};
+
+// Staged generation: a search can ask for the captures first and only produce the quiet moves if no cutoff
+// happened. Captures includes en passant and every promotion; Quiets is the rest, castling included.
+// Evasions is empty unless the side to move is in check, Checks keeps the moves giving check.
+enum class gen_mode { All, Captures, Quiets, Evasions, Checks };
+
+// Checks and pins against one side's king, computed once per position so the direct generator can emit
+// only legal moves without playing them out
+struct legality_info
+{
+    piece_t::color_t color;
+    move_t           king_pos;
+    bitboard_t       checkers;
+    bitboard_t       check_mask;  // Where non-king moves must land: anywhere, the check ray, or nowhere
+    bitboard_t       pinned;      // Each may only move along tables::line[king_pos][its square]
 };
 
 class move_generator
@@ -51,19 +57,88 @@ public:
     static std::vector<move_info> get_legal_moves(const board_t& board, const game_state& state, move_t pos);
     static bool                   is_legal_move(const board_t& board, const game_state& state, move_t from, move_t to);
 
+    // Allocation-free overloads, appending to the caller's list
+    static void get_pseudo_legal_moves(const board_t& board, const game_state& state, move_t pos, move_list& moves);
+    static void get_legal_moves(const board_t& board, const game_state& state, move_t pos, move_list& moves);
+
+    // Direct legal generation: checkers and pins are found once, then only legal moves are emitted.
+    // get_legal_moves is built on these; callers looping over many pieces should compute the info once.
+    static legality_info compute_legality_info(const board_t& board, piece_t::color_t color);
+    static void          generate_legal_moves(const board_t&       board,
+                                              const game_state&    state,
+                                              move_t               pos,
+                                              const legality_info& info,
+                                              move_list&           moves);
+
+    // Every legal move of the side to move, with checks and pins computed once for the whole position
+    static void generate_all(const board_t& board, const game_state& state, move_list& moves);
+
+    // Legal moves of the side to move restricted to one stage, see gen_mode
+    template <gen_mode Mode>
+    static void generate(const board_t& board, const game_state& state, move_list& moves);
+
+    // Whether a legal move of the side to move attacks the enemy king once played, discovered checks included
+    static bool gives_check(const board_t& board, const move_info& move);
+
+    // Whether a piece of 'attacker' attacks the square, read from the attack maps when the board tracks them
+    static bool is_square_attacked(const board_t& board, move_t square, piece_t::color_t attacker);
+
     static bool is_in_check(const board_t& board, game_state::player_turn player);
     static bool is_checkmate(const board_t& board, const game_state& state);
     static bool is_stalemate(const board_t& board, const game_state& state);
 
 private:
-    static std::vector<move_info> get_pawn_moves(const board_t& board, const game_state& state, move_t pos);
-    static std::vector<move_info> get_rook_moves(const board_t& board, move_t pos);
-    static std::vector<move_info> get_knight_moves(const board_t& board, move_t pos);
-    static std::vector<move_info> get_bishop_moves(const board_t& board, move_t pos);
-    static std::vector<move_info> get_queen_moves(const board_t& board, move_t pos);
-    static std::vector<move_info> get_king_moves(const board_t& board, const game_state& state, move_t pos);
-
-    static bool is_square_attacked(const board_t& board, move_t square, game_state::player_turn attacker);
+    static void get_pawn_moves(const board_t& board, const game_state& state, move_t pos, move_list& moves);
+    static void get_rook_moves(const board_t& board, move_t pos, move_list& moves);
+    static void get_knight_moves(const board_t& board, move_t pos, move_list& moves);
+    static void get_bishop_moves(const board_t& board, move_t pos, move_list& moves);
+    static void get_queen_moves(const board_t& board, move_t pos, move_list& moves);
+    static void get_king_moves(const board_t& board, const game_state& state, move_t pos, move_list& moves);
+
+    // Everything below is templated on the side to move (or the attacking side), picked once by the public
+    // entry points, so the color dependent constants fold away inside the loops
+    template <piece_t::color_t Us>
+    static void get_king_moves(const board_t& board, const game_state& state, move_t pos, move_list& moves);
+
+    template <piece_t::color_t Attacker>
+    static bool is_square_attacked(const board_t& board, move_t square);
+    template <piece_t::color_t Color>
+    static bitboard_t attackers_to(const board_t& board, move_t square, bitboard_t occupancy);
+
+    template <piece_t::color_t Us>
+    static legality_info compute_legality_info(const board_t& board);
+    template <piece_t::color_t Us>
+    static void generate_legal_moves(const board_t&       board,
+                                     const game_state&    state,
+                                     move_t               pos,
+                                     const legality_info& info,
+                                     move_list&           moves);
+    template <gen_mode Mode, piece_t::color_t Us>
+    static void generate(const board_t& board, const game_state& state, move_list& moves);
+    template <piece_t::color_t Us>
+    static bool gives_check(const board_t& board, const move_info& move);
+
+    template <gen_mode Mode, piece_t::color_t Us>
+    static bitboard_t mode_targets(const board_t& board);
+
+    template <gen_mode Mode, piece_t::color_t Us>
+    static void generate_legal_pawn_moves(const board_t&       board,
+                                          const game_state&    state,
+                                          move_t               pos,
+                                          const legality_info& info,
+                                          move_list&           moves);
+    template <piece_t::type_t Type, piece_t::color_t Us>
+    static void generate_legal_piece_moves(const board_t&       board,
+                                           const legality_info& info,
+                                           bitboard_t           target_mask,
+                                           bitboard_t           pieces,
+                                           move_list&           moves);
+    template <gen_mode Mode, piece_t::color_t Us>
+    static void generate_legal_king_moves(const board_t&       board,
+                                          const game_state&    state,
+                                          const legality_info& info,
+                                          move_list&           moves);
+
     static bool has_legal_moves(const board_t& board, const game_state& state);
 };
 
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "game/board.hpp"
+#include "game/game_state.hpp"
+
+namespace chessfml {
+
+// Whole position in 38 bytes, for storing many of them (opening books, game records, search snapshots).
+// One nibble per square, bit 3 set for black and the low bits holding piece_t::type_t, then the game state.
+// The check flag is left out since it follows from the position
+struct packed_position
+{
+    std::array<std::uint8_t, 32> squares;          // Square 2i in the low nibble of byte i, 2i+1 in the high one
+    std::uint8_t                 flags;            // Bit 0: black to move, bits 1-4: castling rights
+    std::uint8_t                 en_passant;       // Target square, or no_en_passant
+    std::uint8_t                 halfmove_clock;   // Saturates at 255, well past the fifty-move rule
+    std::uint8_t                 padding;          // Always zero, so packed positions compare bytewise
+    std::uint16_t                fullmove_number;
+
+    static constexpr std::uint8_t no_en_passant = 0xFF;
+
+    bool operator==(const packed_position&) const noexcept = default;
+};
+
+static_assert(sizeof(packed_position) == 38);
+
+[[nodiscard]] packed_position pack_position(const board_t& board, const game_state& state) noexcept;
+
+// Overwrites both the board and the state, including the check flag
+void unpack_position(const packed_position& packed, board_t& board, game_state& state) noexcept;
+
+}  // namespace chessfml
@@ -2,63 +2,76 @@
 
 #include <cstdint>
 #include <print>
+#include <utility>
 
 namespace chessfml {
 
+// One byte per piece: the type in the low three bits and the color in bit 3. The square is the index in
+// board_t, and whether a pawn may double push or a side may castle is derived from the rank and game_state
 class piece_t
 {
 public:
-    using pos_t = std::uint8_t;
-
-    enum class type_t { Empty = 0, Pawn, Rook, Knight, Bishop, Queen, King };
-    enum class color_t { White = 0, Black };
+    enum class type_t : std::uint8_t { Empty = 0, Pawn, Rook, Knight, Bishop, Queen, King };
+    enum class color_t : std::uint8_t { White = 0, Black };
 
     piece_t() noexcept = default;
-    piece_t(type_t t, pos_t pos, color_t c = color_t::White) : m_type(t), m_pos(pos), m_color(c) {}
-    // std::string to_algebraic_notation() const { return "a1"; }
+    piece_t(type_t t, color_t c = color_t::White) noexcept : m_code(encode(t, c)) {}
 
     piece_t(const piece_t&) = default;
     piece_t(piece_t&&) = default;
-    piece_t& operator=(piece_t&) = default;
+    piece_t& operator=(const piece_t&) = default;
     piece_t& operator=(piece_t&&) = default;
 
+    bool operator==(const piece_t&) const noexcept = default;
+
     char c_type() const noexcept
     {
-        switch (m_type) {
+        const bool is_white = get_color() == color_t::White;
+
+        switch (get_type()) {
             case type_t::Pawn:
-                return m_color == color_t::White ? 'P' : 'p';
+                return is_white ? 'P' : 'p';
             case type_t::Rook:
-                return m_color == color_t::White ? 'R' : 'r';
+                return is_white ? 'R' : 'r';
             case type_t::Knight:
-                return m_color == color_t::White ? 'N' : 'n';
+                return is_white ? 'N' : 'n';
             case type_t::Bishop:
-                return m_color == color_t::White ? 'B' : 'b';
+                return is_white ? 'B' : 'b';
             case type_t::Queen:
-                return m_color == color_t::White ? 'Q' : 'q';
+                return is_white ? 'Q' : 'q';
             case type_t::King:
-                return m_color == color_t::White ? 'K' : 'k';
+                return is_white ? 'K' : 'k';
             default:
                 return '.';
         }
     }
 
-    const type_t&  get_type() const noexcept { return m_type; }
-    const pos_t&   get_pos() const noexcept { return m_pos; }
-    const color_t& get_color() const noexcept { return m_color; }
-    bool           has_moved() const noexcept { return m_has_moved; }
+    type_t  get_type() const noexcept { return static_cast<type_t>(m_code & type_mask); }
+    color_t get_color() const noexcept { return static_cast<color_t>(m_code >> color_shift); }
 
-    void set_type(type_t type) noexcept { m_type = type; }
-    void set_pos(pos_t pos) noexcept { m_pos = pos; }
-    void set_color(color_t color) noexcept { m_color = color; }
-    void set_moved(bool moved) noexcept { m_has_moved = moved; }
+    void set_type(type_t type) noexcept { m_code = encode(type, get_color()); }
+    void set_color(color_t color) noexcept { m_code = encode(get_type(), color); }
 
-    void print() const { std::println("type: {} pos: {}", c_type(), get_pos()); }
+    void print() const { std::println("type: {}", c_type()); }
 
 private:
-    type_t  m_type;
-    pos_t   m_pos;
-    color_t m_color;
-    bool    m_has_moved{false};
+    static constexpr std::uint8_t type_mask = 0x07;
+    static constexpr unsigned     color_shift = 3;
+
+    static constexpr std::uint8_t encode(type_t type, color_t color) noexcept
+    {
+        return static_cast<std::uint8_t>(std::to_underlying(type) | (std::to_underlying(color) << color_shift));
+    }
+
+    std::uint8_t m_code{0};  // Empty
 };
 
+static_assert(sizeof(piece_t) == 1);
+
+// The other side, constexpr so color-templated code can name it as a template argument
+constexpr piece_t::color_t opposite(piece_t::color_t color) noexcept
+{
+    return color == piece_t::color_t::White ? piece_t::color_t::Black : piece_t::color_t::White;
+}
+
 }  // namespace chessfml
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <utility>
+
+#include "common/config.hpp"
+#include "game/piece.hpp"
+
+namespace chessfml {
+
+class board_t;
+class game_state;
+
+// 64-bit position key: the XOR of one random key per piece on its square, side to move, castling rights and
+// en passant file
+using zobrist_t = std::uint64_t;
+
+namespace zobrist {
+
+namespace detail {
+
+struct key_table
+{
+    std::array<std::array<std::array<zobrist_t, 64>, 6>, 2> pieces;  // [color][type - Pawn][square]
+    zobrist_t                                               black_to_move;
+    std::array<zobrist_t, 16>                               castling;  // Indexed by the raw castling flags
+    std::array<zobrist_t, 8>                                en_passant_file;
+};
+
+// splitmix64 with a fixed seed, so keys are identical across builds and runs
+constexpr zobrist_t next_key(std::uint64_t& state) noexcept
+{
+    state += 0x9E3779B97F4A7C15ULL;
+    auto z = state;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+constexpr key_table make_keys() noexcept
+{
+    key_table     table{};
+    std::uint64_t state = 0x2545F4914F6CDD1DULL;
+
+    for (auto& color : table.pieces) {
+        for (auto& type : color) {
+            for (auto& key : type) {
+                key = next_key(state);
+            }
+        }
+    }
+
+    table.black_to_move = next_key(state);
+
+    // No rights hashes to zero, so a position without castling rights does not depend on this table
+    for (std::size_t rights = 1; rights < table.castling.size(); ++rights) {
+        table.castling[rights] = next_key(state);
+    }
+
+    for (auto& key : table.en_passant_file) {
+        key = next_key(state);
+    }
+
+    return table;
+}
+
+}  // namespace detail
+
+inline constexpr detail::key_table keys = detail::make_keys();
+
+constexpr zobrist_t piece_key(piece_t::color_t color, piece_t::type_t type, move_t pos) noexcept
+{
+    return keys.pieces[std::to_underlying(color)][std::to_underlying(type) - 1][pos];
+}
+
+constexpr zobrist_t castling_key(std::uint8_t rights) noexcept
+{
+    return keys.castling[rights & 0x0F];
+}
+
+constexpr zobrist_t en_passant_key(move_t target) noexcept
+{
+    return keys.en_passant_file[target % config::board::size];
+}
+
+// Key of the position, computed from scratch
+[[nodiscard]] zobrist_t compute(const board_t& board, const game_state& state) noexcept;
+
+}  // namespace zobrist
+
+}  // namespace chessfml
@@ -9,12 +9,13 @@
 
 namespace chessfml::states {
 
-enum class winner_t;  // Forward declaration
+enum class winner_t;    // Forward declaration
+enum class game_end_t;  // Forward declaration
 
 class game_over : public state
 {
 public:
-    game_over(sf::RenderWindow& window, const board_t& final_board, winner_t winner);
+    game_over(sf::RenderWindow& window, const board_t& final_board, winner_t winner, game_end_t reason);
     ~game_over() override = default;
 
     void init() override;
@@ -27,6 +28,7 @@ private:
     board_renderer                                     m_renderer;
     board_t                                            m_final_board;
     winner_t                                           m_winner;
+    game_end_t                                         m_reason;
     std::chrono::time_point<std::chrono::steady_clock> m_start_time;
     float                                              m_countdown{3.0f};
 
@@ -1,11 +1,17 @@
 #pragma once
 
 #include "game/board.hpp"
+#include "game/engine/search.hpp"
 #include "game/game_state.hpp"
+#include "game/key_history.hpp"
 #include "game/moves.hpp"
 #include "states/state.hpp"
 #include "ui/board_renderer.hpp"
 
+#include <array>
+#include <chrono>
+#include <future>
+#include <optional>
 #include <vector>
 
 namespace chessfml::states {
@@ -25,6 +31,7 @@ private:
 };
 
 enum class winner_t { None, White, Black, Draw };
+enum class game_end_t { Checkmate, Stalemate, Repetition, FiftyMoves };
 
 class play : public state
 {
@@ -37,7 +44,7 @@ public:
          player_t          white_player = player_t ::Human,
          player_t          black_player = player_t ::Human);
 
-    ~play() override = default;
+    ~play() override;
 
     void init() override;
     void handle_event(const sf::Event& event) override;
@@ -56,32 +63,39 @@ private:
 
     // Move execution
     bool execute_move(const move_info& move);
-    void move_piece_board(move_t from, move_t to);
-    void handle_en_passant(move_t from, move_t to);
-    void handle_castling(move_t from, move_t to);
-    void update_game_state_after_move(move_t from, move_t to);
     void check_for_game_over();
 
     // Ai related
-    bool                     is_current_player_ai() const;
-    void                     handle_ai_turn(float dt);
-    std::optional<move_info> calculate_ai_move();
+    bool is_current_player_ai() const;
+    void handle_ai_turn(float dt);
+    void start_ai_search();
 
     sf::RenderWindow& m_window;
     board_renderer    m_renderer;
 
     board_t                m_board;
     game_state             m_game_state;
+    key_history            m_history;  // Every position of the game, for threefold repetition
     selection_system       m_selection;
     std::vector<move_info> m_current_valid_moves;
 
     player_t m_white_player{player_t ::Human};
     player_t m_black_player{player_t ::Human};
 
-    float m_ai_move_timer{0.0f};
-    float m_ai_move_delay{1.0f};  // 1 second delay between AI moves, to make it feel less robotic
-    bool  m_waiting_for_ai_move{false};
-    bool  m_board_locked{false};  // When true, user inputs affecting the board are ignored
+    // The AI searches on a worker thread while its clock runs. Declared in this order so the pending search is
+    // waited for before the searcher it runs on is destroyed
+    engine::searcher                   m_searcher;
+    std::future<engine::search_result> m_ai_search;
+
+    // Remaining thinking time of each side when played by the AI, indexed by color. The time spent on a move is
+    // taken off once it is played, then the increment is added
+    std::array<std::chrono::milliseconds, 2> m_ai_clock{std::chrono::minutes{1}, std::chrono::minutes{1}};
+    std::chrono::milliseconds                m_ai_increment{std::chrono::seconds{1}};
+
+    float              m_ai_move_timer{0.0f};  // Seconds the current AI move has been thinking for
+    std::optional<int> m_ai_mate_in;           // Full moves to the mate the AI last saw, negative when it gets mated
+    bool               m_waiting_for_ai_move{false};
+    bool               m_board_locked{false};  // When true, user inputs affecting the board are ignored
 };
 
 }  // namespace chessfml::states
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "game/board.hpp"
+#include "game/game_state.hpp"
+#include "game/move.hpp"
+
+namespace chessfml::perft {
+
+using node_count = std::uint64_t;
+
+struct divide_entry
+{
+    move_info  move;
+    node_count nodes;
+};
+
+// Leaf nodes of the legal move tree 'depth' plies below the position. The last ply is bulk counted from the
+// size of the move list instead of being played. The position is restored before returning
+[[nodiscard]] node_count count(board_t& board, game_state& state, int depth);
+
+struct options
+{
+    unsigned    threads{0};  // 0 uses one thread per hardware core
+    std::size_t hash_mb{0};  // Size of the shared transposition table, 0 disables it
+};
+
+struct divide_result
+{
+    std::vector<divide_entry> moves;
+    std::uint64_t             table_probes{0};
+    std::uint64_t             table_hits{0};
+};
+
+// The same count split by root move, in generation order. The tree is cut into subtrees a ply or two below the
+// root and spread over a work-stealing pool, each worker playing its subtrees on its own board copy. Totals do
+// not depend on the thread count. With a hash size set, subtree counts are cached by (position key, depth) in
+// a table shared by all workers, so transpositions are only counted once
+[[nodiscard]] divide_result divide(const board_t& board, const game_state& state, int depth, const options& opts);
+
+}  // namespace chessfml::perft
@@ -8,18 +8,27 @@
 
 namespace chessfml::states {
 
-game_over::game_over(sf::RenderWindow& window, const board_t& final_board, winner_t winner)
-    : m_window(window), m_renderer(window), m_final_board(final_board), m_winner(winner)
+game_over::game_over(sf::RenderWindow& window, const board_t& final_board, winner_t winner, game_end_t reason)
+    : m_window(window), m_renderer(window), m_final_board(final_board), m_winner(winner), m_reason(reason)
 {}
 
 void game_over::init()
 {
     m_start_time = std::chrono::steady_clock::now();
 
-    if (m_winner == winner_t::Draw) {
-        m_checkmate_text = sf::Text(m_font, "Stalemate!", 64);
-    } else {
-        m_checkmate_text = sf::Text(m_font, "Checkmate!", 64);
+    switch (m_reason) {
+        case game_end_t::Checkmate:
+            m_checkmate_text = sf::Text(m_font, "Checkmate!", 64);
+            break;
+        case game_end_t::Stalemate:
+            m_checkmate_text = sf::Text(m_font, "Stalemate!", 64);
+            break;
+        case game_end_t::Repetition:
+            m_checkmate_text = sf::Text(m_font, "Threefold repetition!", 64);
+            break;
+        case game_end_t::FiftyMoves:
+            m_checkmate_text = sf::Text(m_font, "Fifty-move rule!", 64);
+            break;
     }
 
     m_checkmate_text.setFillColor(sf::Color::White);
@@ -10,7 +10,7 @@
 
 #include <algorithm>
 #include <chrono>
-#include <random>
+#include <format>
 #include <thread>
 
 namespace {
@@ -46,17 +46,31 @@ play::play(sf::RenderWindow& window,
       m_black_player(black_player)
 {}
 
-void play::init()
+play::~play()
 {
-    bool is_board_empty = std::all_of(
-        m_board.begin(), m_board.end(), [](const auto& piece) { return piece.get_type() == piece_t::type_t::Empty; });
+    // Leaving the game mid-search, the result is not needed
+    m_searcher.stop();
+}
 
-    if (is_board_empty) {
+void play::init()
+{
+    if (m_board.occupancy() == bitboard::empty) {
         m_board.set_board_fen(config::board::fen_starting_position);
     }
 
+    // Only a handful of moves are played on this board, so keeping the attack maps is cheap and makes every
+    // attacked-square query a bit test
+    m_board.set_attack_tracking(true);
+
+    // The AI thinks with every core, the game itself barely uses one
+    m_searcher.set_threads(std::max(1u, std::thread::hardware_concurrency()));
+    m_searcher.set_hash_size(config::engine::hash_size_mb);
+
     m_game_state.set_check(move_generator::is_in_check(m_board, m_game_state.get_player_turn()));
 
+    m_history.clear();
+    m_history.push(position_key(m_board, m_game_state));
+
     // Lock the board if AI plays as white (needs to make first move)
     m_board_locked = m_game_state.get_player_turn() == game_state::player_turn::White && m_white_player == player_t::AI;
     m_waiting_for_ai_move = m_board_locked;
@@ -119,6 +133,17 @@ void play::render()
     m_window.draw(shadow);
     m_window.draw(turn_indicator);
 
+    if (m_ai_mate_in) {
+        sf::Text mate_text{get_font()};
+        mate_text.setCharacterSize(20);
+        mate_text.setString(*m_ai_mate_in > 0 ? std::format("AI mates in {}", *m_ai_mate_in)
+                                              : std::format("AI gets mated in {}", -*m_ai_mate_in));
+        mate_text.setFillColor(sf::Color(220, 100, 100));  // Red-ish
+        mate_text.setPosition({20, 55});
+
+        m_window.draw(mate_text);
+    }
+
     if (m_waiting_for_ai_move) {
         sf::Text thinking_text{get_font()};
         thinking_text.setCharacterSize(20);
@@ -134,60 +159,60 @@ void play::handle_ai_turn(float dt)
 {
     m_board_locked = true;
 
-    // Add a delay before AI moves to make it more natural
-    if (m_waiting_for_ai_move) {
-        m_ai_move_timer += dt;
-        if (m_ai_move_timer >= m_ai_move_delay) {
-            m_ai_move_timer = 0.0f;
-            m_waiting_for_ai_move = false;
-
-            try {
-                auto ai_move_opt = calculate_ai_move();
-                if (ai_move_opt) {
-                    bool move_result = execute_move(*ai_move_opt);
-
-                    if (!move_result) {
-                        std::println("AI move failed: from {} to {}", ai_move_opt->from, ai_move_opt->to);
-                    }
-                }
-            } catch (const std::exception& e) {
-                std::println("Error during AI move: {}", e.what());
+    if (!m_ai_search.valid()) {
+        start_ai_search();
+        return;
+    }
+
+    // The search keeps to the clock it was given, the timer charges what it actually took
+    m_ai_move_timer += dt;
+    if (m_ai_search.wait_for(std::chrono::seconds{0}) != std::future_status::ready) {
+        return;
+    }
+
+    auto&      clock = m_ai_clock[std::to_underlying(m_game_state.get_player_turn())];
+    const auto spent = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::duration<float>{m_ai_move_timer});
+
+    // A flag fall is not a loss here, the AI just keeps moving on its increment
+    clock = std::max(clock - spent, std::chrono::milliseconds{0}) + m_ai_increment;
+
+    m_ai_move_timer = 0.0f;
+    m_waiting_for_ai_move = false;
+
+    try {
+        const auto result = m_ai_search.get();
+        m_ai_mate_in =
+            engine::is_mate_score(result.score) ? std::optional{engine::mate_in(result.score)} : std::nullopt;
+        if (result.best_move) {
+            bool move_result = execute_move(*result.best_move);
+
+            if (!move_result) {
+                std::println("AI move failed: from {} to {}", result.best_move->from, result.best_move->to);
             }
         }
-    } else {
-        m_waiting_for_ai_move = true;
-        m_ai_move_timer = 0.0f;
+    } catch (const std::exception& e) {
+        std::println("Error during AI move: {}", e.what());
     }
 }
 
-std::optional<move_info> play::calculate_ai_move()
+void play::start_ai_search()
 {
-    std::vector<move_info> all_legal_moves;
-    const auto             player_turn = m_game_state.get_player_turn();
-    const auto             piece_color =
-        (player_turn == game_state::player_turn::White) ? piece_t::color_t::White : piece_t::color_t::Black;
-
     clear_selection();
 
-    for (move_t pos = 0; pos < 64; ++pos) {
-        const auto& piece = m_board[pos];
-        if (piece.get_type() != piece_t::type_t::Empty && piece.get_color() == piece_color) {
-            auto moves = move_generator::get_legal_moves(m_board, m_game_state, pos);
-            all_legal_moves.insert(all_legal_moves.end(), moves.begin(), moves.end());
-        }
-    }
-
-    if (all_legal_moves.empty()) {
-        // No legal moves available (should be detected as checkmate/stalemate elsewhere)
-        return std::nullopt;
-    }
+    m_waiting_for_ai_move = true;
+    m_ai_move_timer = 0.0f;
 
-    static std::random_device                  rd;
-    static std::mt19937                        gen(rd());
-    std::uniform_int_distribution<std::size_t> dist(0, all_legal_moves.size() - 1);
-    std::size_t                                randomIndex = dist(gen);
+    const engine::search_limits limits{
+        .time_left = m_ai_clock[std::to_underlying(m_game_state.get_player_turn())],
+        .increment = m_ai_increment,
+    };
 
-    return all_legal_moves[randomIndex];
+    // The worker gets its own copy of the game, so the board can keep being drawn meanwhile
+    m_ai_search = std::async(std::launch::async,
+                             [this, board = m_board, state = m_game_state, history = m_history, limits] {
+                                 return m_searcher.search(board, state, history, limits);
+                             });
 }
 
 bool play::is_current_player_ai() const
@@ -286,88 +311,15 @@ move_t play::convert_to_board_pos(const sf::Vector2i& mouse_pos) const
 
 bool play::execute_move(const move_info& move)
 {
-    if (move.is_en_passant()) {
-        handle_en_passant(move.from, move.to);
-    }
-
-    if (move.is_castling()) {
-        handle_castling(move.from, move.to);
-    }
-
-    if (move.is_promotion()) {
-        m_board[move.from].set_type(static_cast<piece_t::type_t>(move.promotion_piece));
-    }
-
-    move_piece_board(move.from, move.to);
-    update_game_state_after_move(move.from, move.to);
-
-    return true;
-}
-
-void play::move_piece_board(move_t from, move_t to)
-{
-    m_board[to] = m_board[from];
-    m_board[to].set_pos(to);
-    m_board[to].set_moved(true);
-    m_board[from] = piece_t{};
-}
-
-void play::handle_en_passant(move_t from, move_t to)
-{
-    const auto [capture_rank, capture_file] = position_to_rank_file(to);
-    const auto   piece_color = m_board[from].get_color();
-    const int    ep_rank = piece_color == piece_t::color_t::White ? capture_rank + 1 : capture_rank - 1;
-    const move_t ep_pos = rank_file_to_position(ep_rank, capture_file);
-
-    m_board[ep_pos] = piece_t{};
-}
-
-void play::handle_castling(move_t from, move_t to)
-{
-    const auto piece_color = m_board[from].get_color();
-    const bool is_kingside = to > from;
-
-    if (is_kingside) {
-        // Kingside castling: rook moves from h1/h8 to f1/f8
-        const move_t rook_from = (piece_color == piece_t::color_t::White) ? 7 : 63;
-        const move_t rook_to = (piece_color == piece_t::color_t::White) ? 5 : 61;
-
-        move_piece_board(rook_from, rook_to);
-    } else {
-        // Queenside castling: rook moves from a1/a8 to d1/d8
-        const move_t rook_from = (piece_color == piece_t::color_t::White) ? 0 : 56;
-        const move_t rook_to = (piece_color == piece_t::color_t::White) ? 3 : 59;
-
-        move_piece_board(rook_from, rook_to);
-    }
-}
-
-void play::update_game_state_after_move(move_t from, move_t to)
-{
-    if (m_board[to].get_type() == piece_t::type_t::Pawn &&
-        std::abs(static_cast<int>(to) - static_cast<int>(from)) == 16) {
-        // Pawn moved two squares, set en passant target
-        m_game_state.set_en_passant_target((from + to) / 2);
-    } else {
-        m_game_state.set_en_passant_target(std::nullopt);
-    }
-
-    if (m_board[to].get_type() == piece_t::type_t::King) {
-        m_game_state.disable_kingside_castling(m_game_state.get_player_turn());
-        m_game_state.disable_queenside_castling(m_game_state.get_player_turn());
-    } else if (m_board[to].get_type() == piece_t::type_t::Rook) {
-        if (from == (m_game_state.get_player_turn() == game_state::player_turn::White ? 0 : 56)) {
-            m_game_state.disable_queenside_castling(m_game_state.get_player_turn());
-        } else if (from == (m_game_state.get_player_turn() == game_state::player_turn::White ? 7 : 63)) {
-            m_game_state.disable_kingside_castling(m_game_state.get_player_turn());
-        }
-    }
-
-    m_game_state.next_turn();
+    // The undo record is only needed by search, the game itself never takes a move back
+    [[maybe_unused]] const auto undo = m_board.make_move(move, m_game_state);
+    m_history.push(position_key(m_board, m_game_state));
 
     m_game_state.set_check(move_generator::is_in_check(m_board, m_game_state.get_player_turn()));
 
     check_for_game_over();
+
+    return true;
 }
 
 void play::check_for_game_over()
@@ -381,10 +333,14 @@ void play::check_for_game_over()
             winner = winner_t::White;
         }
 
-        m_manager->push_state<game_over>(m_window, m_board, winner);
+        m_manager->push_state<game_over>(m_window, m_board, winner, game_end_t::Checkmate);
     } else if (move_generator::is_stalemate(m_board, m_game_state)) {
         // Stalemate is a draw
-        m_manager->push_state<game_over>(m_window, m_board, winner_t::Draw);
+        m_manager->push_state<game_over>(m_window, m_board, winner_t::Draw, game_end_t::Stalemate);
+    } else if (m_history.is_threefold(m_game_state.get_halfmove_clock())) {
+        m_manager->push_state<game_over>(m_window, m_board, winner_t::Draw, game_end_t::Repetition);
+    } else if (m_game_state.is_fifty_move_draw()) {
+        m_manager->push_state<game_over>(m_window, m_board, winner_t::Draw, game_end_t::FiftyMoves);
     }
 }
 
@@ -0,0 +1,357 @@
+#include "common/config.hpp"
+#include "common/fen.hpp"
+#include "game/attacks.hpp"
+#include "game/moves.hpp"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <format>
+#include <functional>
+#include <print>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+using namespace chessfml;
+
+// Fixed corpus, so numbers stay comparable release over release. Append new positions, never edit old ones
+constexpr std::array<std::string_view, 10> corpus = {
+    config::board::fen_starting_position,
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",      // Kiwipete
+    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",                                 // Rook endgame
+    "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",          // Promotions
+    "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",                 // Promotion captures
+    "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",  // Symmetric middlegame
+    "r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R w KQkq - 2 3",          // Opening
+    "8/5pk1/6p1/8/3B4/5PK1/6P1/8 b - - 0 40",                                    // Minor piece endgame
+    "rnb1kbnr/pppp1ppp/8/4p3/6Pq/5P2/PPPPP2P/RNBQKBNR w KQkq - 1 3",             // Checkmated
+    "4k3/8/8/8/8/8/4q3/4K3 w - - 0 1",                                           // In check
+};
+
+// Defaults keep a full run to a few seconds
+constexpr unsigned                  default_samples = 30;
+constexpr unsigned                  default_warmup = 3;
+constexpr std::chrono::microseconds sample_target{2000};
+
+struct position
+{
+    board_t    board;
+    game_state state;
+};
+
+// What one pass over the corpus did: the operations timed, and a checksum of their results so the work cannot
+// be optimized away and a behavior change shows up next to the timings
+struct pass_result
+{
+    std::uint64_t ops{0};
+    std::uint64_t checksum{0};
+};
+
+struct benchmark
+{
+    std::string                  name;
+    std::function<pass_result()> pass;
+};
+
+struct statistics
+{
+    double min;
+    double median;
+    double p90;
+    double p99;
+    double max;
+    double mean;
+};
+
+struct measurement
+{
+    std::string_view name;
+    pass_result      last_pass;
+    unsigned         passes_per_sample;
+    statistics       ns_per_op;
+};
+
+piece_t::color_t side_to_move(const game_state& state)
+{
+    return state.get_player_turn() == game_state::player_turn::White ? piece_t::color_t::White
+                                                                     : piece_t::color_t::Black;
+}
+
+std::string_view type_name(piece_t::type_t type)
+{
+    switch (type) {
+        case piece_t::type_t::Pawn:
+            return "pawn";
+        case piece_t::type_t::Rook:
+            return "rook";
+        case piece_t::type_t::Knight:
+            return "knight";
+        case piece_t::type_t::Bishop:
+            return "bishop";
+        case piece_t::type_t::Queen:
+            return "queen";
+        case piece_t::type_t::King:
+            return "king";
+        default:
+            return "empty";
+    }
+}
+
+std::vector<benchmark> make_benchmarks(const std::vector<position>& positions)
+{
+    std::vector<benchmark> benchmarks;
+
+    // One call per piece of the side to move, grouped by type
+    for (auto type : {piece_t::type_t::Pawn,
+                      piece_t::type_t::Knight,
+                      piece_t::type_t::Bishop,
+                      piece_t::type_t::Rook,
+                      piece_t::type_t::Queen,
+                      piece_t::type_t::King}) {
+        benchmarks.push_back({std::format("get_legal_moves/{}", type_name(type)), [&positions, type] {
+                                  pass_result result;
+                                  move_list   moves;
+                                  for (const auto& [board, state] : positions) {
+                                      for (auto pieces = board.pieces(type, side_to_move(state));
+                                           pieces != bitboard::empty;) {
+                                          moves.clear();
+                                          move_generator::get_legal_moves(
+                                              board, state, bitboard::pop_lsb(pieces), moves);
+                                          result.checksum += moves.size();
+                                          ++result.ops;
+                                      }
+                                  }
+                                  return result;
+                              }});
+    }
+
+    benchmarks.push_back({"is_square_attacked", [&positions] {
+                              pass_result result;
+                              for (const auto& [board, state] : positions) {
+                                  const auto attacker = opposite(side_to_move(state));
+                                  for (move_t square = 0; square < 64; ++square) {
+                                      result.checksum += move_generator::is_square_attacked(board, square, attacker);
+                                      ++result.ops;
+                                  }
+                              }
+                              return result;
+                          }});
+
+    benchmarks.push_back({"is_in_check", [&positions] {
+                              pass_result result;
+                              for (const auto& [board, state] : positions) {
+                                  result.checksum += move_generator::is_in_check(board, state.get_player_turn());
+                                  ++result.ops;
+                              }
+                              return result;
+                          }});
+
+    benchmarks.push_back({"is_checkmate", [&positions] {
+                              pass_result result;
+                              for (const auto& [board, state] : positions) {
+                                  result.checksum += move_generator::is_checkmate(board, state);
+                                  ++result.ops;
+                              }
+                              return result;
+                          }});
+
+    benchmarks.push_back({"generate_all", [&positions] {
+                              pass_result result;
+                              move_list   moves;
+                              for (const auto& [board, state] : positions) {
+                                  moves.clear();
+                                  move_generator::generate_all(board, state, moves);
+                                  result.checksum += moves.size();
+                                  ++result.ops;
+                              }
+                              return result;
+                          }});
+
+    benchmarks.push_back({"fen::parse_fen", [] {
+                              pass_result result;
+                              board_t     board;
+                              game_state  state;
+                              for (const auto fen : corpus) {
+                                  if (!fen::parse_fen(fen, board, state)) {
+                                      result.checksum += bitboard::count(board.occupancy());
+                                  }
+                                  ++result.ops;
+                              }
+                              return result;
+                          }});
+
+    benchmarks.push_back({"fen::create_fen", [&positions] {
+                              pass_result result;
+                              for (const auto& [board, state] : positions) {
+                                  result.checksum += fen::create_fen(board, state).size();
+                                  ++result.ops;
+                              }
+                              return result;
+                          }});
+
+    return benchmarks;
+}
+
+// Nearest rank on sorted samples
+double percentile(const std::vector<double>& sorted, double p)
+{
+    const auto rank = static_cast<std::size_t>(p / 100.0 * static_cast<double>(sorted.size() - 1) + 0.5);
+    return sorted[std::min(rank, sorted.size() - 1)];
+}
+
+measurement run(const benchmark& bench, unsigned samples, unsigned warmup)
+{
+    using clock = std::chrono::steady_clock;
+
+    pass_result last_pass;
+    for (unsigned i = 0; i < warmup; ++i) {
+        last_pass = bench.pass();
+    }
+
+    // Enough passes per sample that the clock resolution does not matter
+    const auto start = clock::now();
+    last_pass = bench.pass();
+    const auto pass_time = std::max(clock::now() - start, clock::duration{1});
+    const auto passes = static_cast<unsigned>(std::max<clock::rep>(1, sample_target / pass_time));
+
+    std::vector<double> ns_per_op;
+    ns_per_op.reserve(samples);
+
+    for (unsigned i = 0; i < samples; ++i) {
+        const auto sample_start = clock::now();
+        for (unsigned pass = 0; pass < passes; ++pass) {
+            last_pass = bench.pass();
+        }
+        const std::chrono::duration<double, std::nano> elapsed = clock::now() - sample_start;
+        ns_per_op.push_back(elapsed.count() / static_cast<double>(passes * std::max<std::uint64_t>(last_pass.ops, 1)));
+    }
+
+    std::ranges::sort(ns_per_op);
+
+    double total = 0.0;
+    for (const auto ns : ns_per_op) {
+        total += ns;
+    }
+
+    return {.name = bench.name,
+            .last_pass = last_pass,
+            .passes_per_sample = passes,
+            .ns_per_op = {.min = ns_per_op.front(),
+                          .median = percentile(ns_per_op, 50.0),
+                          .p90 = percentile(ns_per_op, 90.0),
+                          .p99 = percentile(ns_per_op, 99.0),
+                          .max = ns_per_op.back(),
+                          .mean = total / static_cast<double>(ns_per_op.size())}};
+}
+
+void print_json(const std::vector<measurement>& results, std::size_t positions, unsigned samples, unsigned warmup)
+{
+    std::println("{{");
+    std::println("  \"tool\": \"chessfml_bench\",");
+    std::println("  \"slider_backend\": \"{}\",",
+                 attacks::active_backend() == attacks::backend::Pext ? "pext" : "magic");
+    std::println("  \"positions\": {},", positions);
+    std::println("  \"samples\": {},", samples);
+    std::println("  \"warmup\": {},", warmup);
+    std::println("  \"results\": [");
+
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const auto& result = results[i];
+        const auto& ns = result.ns_per_op;
+
+        std::println("    {{");
+        std::println("      \"name\": \"{}\",", result.name);
+        std::println("      \"ops_per_pass\": {},", result.last_pass.ops);
+        std::println("      \"passes_per_sample\": {},", result.passes_per_sample);
+        std::println("      \"checksum\": {},", result.last_pass.checksum);
+        std::println("      \"ns_per_op\": {{\"min\": {:.2f}, \"median\": {:.2f}, \"p90\": {:.2f}, \"p99\": {:.2f}, "
+                     "\"max\": {:.2f}, \"mean\": {:.2f}}}",
+                     ns.min,
+                     ns.median,
+                     ns.p90,
+                     ns.p99,
+                     ns.max,
+                     ns.mean);
+        std::println("    }}{}", i + 1 < results.size() ? "," : "");
+    }
+
+    std::println("  ]");
+    std::println("}}");
+}
+
+void print_usage()
+{
+    std::println("usage: chessfml_bench [--samples N] [--warmup N] [--filter TEXT]");
+    std::println("  --samples N    timed samples per benchmark, {} by default", default_samples);
+    std::println("  --warmup N     untimed passes before sampling, {} by default", default_warmup);
+    std::println("  --filter TEXT  only run the benchmarks whose name contains TEXT");
+    std::println("Results are written to stdout as JSON, times in nanoseconds per operation");
+}
+
+// Parses a whole argument as a number
+bool parse_number(std::string_view arg, unsigned& value)
+{
+    const auto [ptr, ec] = std::from_chars(arg.data(), arg.data() + arg.size(), value);
+    return ec == std::errc{} && ptr == arg.data() + arg.size();
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    unsigned         samples = default_samples;
+    unsigned         warmup = default_warmup;
+    std::string_view filter;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg{argv[i]};
+
+        if (arg == "--samples") {
+            if (i + 1 == argc || !parse_number(argv[++i], samples) || samples == 0) {
+                std::println(stderr, "--samples expects a positive number");
+                return 1;
+            }
+        } else if (arg == "--warmup") {
+            if (i + 1 == argc || !parse_number(argv[++i], warmup)) {
+                std::println(stderr, "--warmup expects a number");
+                return 1;
+            }
+        } else if (arg == "--filter") {
+            if (i + 1 == argc) {
+                std::println(stderr, "--filter expects a benchmark name");
+                return 1;
+            }
+            filter = argv[++i];
+        } else if (arg == "--help" || arg == "-h") {
+            print_usage();
+            return 0;
+        } else {
+            print_usage();
+            return 1;
+        }
+    }
+
+    std::vector<position> positions(corpus.size());
+    for (std::size_t i = 0; i < corpus.size(); ++i) {
+        if (const auto error = fen::parse_fen(corpus[i], positions[i].board, positions[i].state)) {
+            std::println(stderr, "Invalid corpus FEN '{}': {}", corpus[i], *error);
+            return 1;
+        }
+    }
+
+    const auto               benchmarks = make_benchmarks(positions);
+    std::vector<measurement> results;
+    for (const auto& bench : benchmarks) {
+        if (bench.name.find(filter) != std::string::npos) {
+            results.push_back(run(bench, samples, warmup));
+        }
+    }
+
+    print_json(results, positions.size(), samples, warmup);
+}
@@ -0,0 +1,280 @@
+#include "tools/perft.hpp"
+
+#include "game/moves.hpp"
+#include "game/zobrist.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+namespace {
+
+using chessfml::move_info;
+using chessfml::zobrist_t;
+using chessfml::perft::node_count;
+
+// A subtree to count: the moves leading to it from the root, and which root move it belongs to
+struct subtree
+{
+    std::size_t              root_index;
+    std::array<move_info, 2> path;
+    int                      path_length;
+    int                      depth;
+};
+
+// One deque per worker. Owners take from the back of their own deque, idle workers steal from the front of
+// the others', so the large subtrees queued first are the ones that move between threads
+class work_queues
+{
+public:
+    explicit work_queues(std::size_t workers) : m_queues(workers) {}
+
+    void push(std::size_t worker, std::size_t task)
+    {
+        std::scoped_lock lock{m_queues[worker].mutex};
+        m_queues[worker].tasks.push_back(task);
+    }
+
+    std::optional<std::size_t> pop(std::size_t worker)
+    {
+        for (std::size_t i = 0; i < m_queues.size(); ++i) {
+            auto&            queue = m_queues[(worker + i) % m_queues.size()];
+            std::scoped_lock lock{queue.mutex};
+
+            if (queue.tasks.empty()) {
+                continue;
+            }
+
+            std::size_t task = 0;
+            if (i == 0) {
+                task = queue.tasks.back();
+                queue.tasks.pop_back();
+            } else {
+                task = queue.tasks.front();
+                queue.tasks.pop_front();
+            }
+            return task;
+        }
+
+        // Tasks never spawn tasks, so every queue being empty means the work is done
+        return std::nullopt;
+    }
+
+private:
+    struct queue
+    {
+        std::mutex              mutex;
+        std::deque<std::size_t> tasks;
+    };
+
+    std::vector<queue> m_queues;
+};
+
+// Lock-free table shared by every worker. A slot holds the key XOR-ed with its data next to the data itself:
+// a slot torn by two concurrent writers no longer validates, and is treated as a miss instead of returning the
+// count of another position
+class perft_table
+{
+public:
+    explicit perft_table(std::size_t megabytes)
+        : m_slots(std::bit_floor(std::max<std::size_t>(megabytes, 1) * 1024 * 1024 / sizeof(slot))),
+          m_mask(m_slots.size() - 1)
+    {}
+
+    std::optional<node_count> probe(zobrist_t key, int depth) const noexcept
+    {
+        const auto& slot = m_slots[key & m_mask];
+        const auto  data = slot.data.load(std::memory_order_relaxed);
+        const auto  check = slot.check.load(std::memory_order_relaxed);
+
+        if ((check ^ data) != key || static_cast<int>(data & depth_mask) != depth) {
+            return std::nullopt;
+        }
+        return data >> depth_bits;
+    }
+
+    // Always replaces: the deeper subtrees are probed first anyway, and they are the ones most often repeated
+    void store(zobrist_t key, int depth, node_count nodes) noexcept
+    {
+        auto&      slot = m_slots[key & m_mask];
+        const auto data = (nodes << depth_bits) | static_cast<std::uint64_t>(depth);
+
+        slot.check.store(key ^ data, std::memory_order_relaxed);
+        slot.data.store(data, std::memory_order_relaxed);
+    }
+
+private:
+    // Counts get the upper 56 bits, far more than any perft that fits in a day
+    static constexpr unsigned      depth_bits = 8;
+    static constexpr std::uint64_t depth_mask = (std::uint64_t{1} << depth_bits) - 1;
+
+    struct slot
+    {
+        std::atomic<std::uint64_t> check{0};
+        std::atomic<std::uint64_t> data{0};
+    };
+
+    std::vector<slot> m_slots;
+    std::size_t       m_mask;
+};
+
+struct table_stats
+{
+    std::uint64_t probes{0};
+    std::uint64_t hits{0};
+};
+
+node_count hashed_count(chessfml::board_t&    board,
+                        chessfml::game_state& state,
+                        int                   depth,
+                        perft_table&          table,
+                        table_stats&          stats)
+{
+    using namespace chessfml;
+
+    // The last ply is bulk counted, cheaper than a probe
+    if (depth <= 1) {
+        return perft::count(board, state, depth);
+    }
+
+    const auto key = position_key(board, state);
+
+    ++stats.probes;
+    if (const auto nodes = table.probe(key, depth)) {
+        ++stats.hits;
+        return *nodes;
+    }
+
+    move_list moves;
+    move_generator::generate_all(board, state, moves);
+
+    node_count nodes = 0;
+    for (const auto& move : moves) {
+        const auto undo = board.make_move(move, state);
+        nodes += hashed_count(board, state, depth - 1, table, stats);
+        board.unmake_move(undo, state);
+    }
+
+    table.store(key, depth, nodes);
+    return nodes;
+}
+
+}  // anonymous namespace
+
+namespace chessfml::perft {
+
+node_count count(board_t& board, game_state& state, int depth)
+{
+    if (depth <= 0) {
+        return 1;
+    }
+
+    move_list moves;
+    move_generator::generate_all(board, state, moves);
+
+    if (depth == 1) {
+        return moves.size();
+    }
+
+    node_count nodes = 0;
+    for (const auto& move : moves) {
+        const auto undo = board.make_move(move, state);
+        nodes += count(board, state, depth - 1);
+        board.unmake_move(undo, state);
+    }
+
+    return nodes;
+}
+
+divide_result divide(const board_t& board, const game_state& state, int depth, const options& opts)
+{
+    const auto threads =
+        std::max(1u, opts.threads != 0 ? opts.threads : std::thread::hardware_concurrency());
+
+    divide_result result;
+    if (depth <= 0) {
+        return result;
+    }
+
+    board_t    root_board = board;
+    game_state root_state = state;
+
+    move_list root_moves;
+    move_generator::generate_all(root_board, root_state, root_moves);
+
+    // Root moves alone rarely keep every core busy until the end, so deeper searches split one ply further
+    const bool split_twice = depth >= 3 && root_moves.size() < threads * 8;
+
+    std::vector<subtree> tasks;
+    for (std::size_t i = 0; i < root_moves.size(); ++i) {
+        result.moves.push_back({.move = root_moves[i], .nodes = 0});
+
+        if (!split_twice) {
+            tasks.push_back({.root_index = i, .path = {root_moves[i]}, .path_length = 1, .depth = depth - 1});
+            continue;
+        }
+
+        const auto undo = root_board.make_move(root_moves[i], root_state);
+
+        move_list replies;
+        move_generator::generate_all(root_board, root_state, replies);
+        for (const auto& reply : replies) {
+            tasks.push_back({.root_index = i, .path = {root_moves[i], reply}, .path_length = 2, .depth = depth - 2});
+        }
+
+        root_board.unmake_move(undo, root_state);
+    }
+
+    // Each task writes its own slot, so the totals are summed in the same order whatever the scheduling
+    std::vector<node_count>  results(tasks.size(), 0);
+    std::vector<table_stats> stats(threads);
+    work_queues              queues{threads};
+
+    std::optional<perft_table> table;
+    if (opts.hash_mb != 0) {
+        table.emplace(opts.hash_mb);
+    }
+
+    for (std::size_t i = 0; i < tasks.size(); ++i) {
+        queues.push(i % threads, i);
+    }
+
+    {
+        std::vector<std::jthread> workers;
+        for (std::size_t worker = 0; worker < threads; ++worker) {
+            workers.emplace_back([&, worker] {
+                while (const auto task_index = queues.pop(worker)) {
+                    const auto& task = tasks[*task_index];
+
+                    board_t    task_board = board;
+                    game_state task_state = state;
+                    for (int ply = 0; ply < task.path_length; ++ply) {
+                        [[maybe_unused]] const auto undo = task_board.make_move(task.path[ply], task_state);
+                    }
+
+                    results[*task_index] =
+                        table ? hashed_count(task_board, task_state, task.depth, *table, stats[worker])
+                              : count(task_board, task_state, task.depth);
+                }
+            });
+        }
+    }
+
+    for (std::size_t i = 0; i < tasks.size(); ++i) {
+        result.moves[tasks[i].root_index].nodes += results[i];
+    }
+
+    for (const auto& worker_stats : stats) {
+        result.table_probes += worker_stats.probes;
+        result.table_hits += worker_stats.hits;
+    }
+
+    return result;
+}
+
+}  // namespace chessfml::perft
@@ -0,0 +1,123 @@
+#include "common/config.hpp"
+#include "common/fen.hpp"
+#include "common/utils.hpp"
+#include "tools/perft.hpp"
+
+#include <charconv>
+#include <chrono>
+#include <print>
+#include <string>
+#include <string_view>
+
+namespace {
+
+void print_usage()
+{
+    std::println("usage: chessfml_perft [--divide] [--threads N] [--hash MB] <depth> [fen]");
+    std::println("  --divide     print the node count below each root move");
+    std::println("  --threads N  worker threads, one per hardware core by default");
+    std::println("  --hash MB    cache subtree counts in a shared table of this size, off by default");
+    std::println("  fen          position to count from, the starting position if omitted");
+}
+
+// Long algebraic notation as used by UCI engines, so divide output can be diffed against them
+std::string to_uci(const chessfml::move_info& move)
+{
+    using namespace chessfml;
+
+    auto notation = position_to_algebraic(move.from) + position_to_algebraic(move.to);
+    if (move.is_promotion()) {
+        notation += piece_t{static_cast<piece_t::type_t>(move.promotion_piece), piece_t::color_t::Black}.c_type();
+    }
+    return notation;
+}
+
+// Parses a whole argument as a non-negative number
+bool parse_number(std::string_view arg, auto& value)
+{
+    const auto [ptr, ec] = std::from_chars(arg.data(), arg.data() + arg.size(), value);
+    return ec == std::errc{} && ptr == arg.data() + arg.size() && value >= 0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    using namespace chessfml;
+
+    bool           with_divide = false;
+    int            depth = -1;
+    perft::options opts;
+    std::string    fen;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg{argv[i]};
+
+        if (arg == "--divide") {
+            with_divide = true;
+        } else if (arg == "--threads") {
+            if (i + 1 == argc || !parse_number(argv[++i], opts.threads)) {
+                std::println("--threads expects a number");
+                return 1;
+            }
+        } else if (arg == "--hash") {
+            if (i + 1 == argc || !parse_number(argv[++i], opts.hash_mb)) {
+                std::println("--hash expects a size in MB");
+                return 1;
+            }
+        } else if (arg == "--help" || arg == "-h") {
+            print_usage();
+            return 0;
+        } else if (depth < 0) {
+            if (!parse_number(arg, depth)) {
+                std::println("Invalid depth: {}", arg);
+                return 1;
+            }
+        } else {
+            // An unquoted FEN arrives split on spaces
+            fen += fen.empty() ? "" : " ";
+            fen += arg;
+        }
+    }
+
+    if (depth < 0) {
+        print_usage();
+        return 1;
+    }
+
+    board_t    board;
+    game_state state;
+    if (const auto error = fen::parse_fen(fen.empty() ? config::board::fen_starting_position : fen, board, state)) {
+        std::println("Invalid FEN: {}", *error);
+        return 1;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+
+    const auto result = perft::divide(board, state, depth, opts);
+
+    perft::node_count nodes = depth == 0 ? 1 : 0;
+    for (const auto& [move, move_nodes] : result.moves) {
+        if (with_divide) {
+            std::println("{}: {}", to_uci(move), move_nodes);
+        }
+        nodes += move_nodes;
+    }
+
+    if (with_divide && depth > 0) {
+        std::println();
+    }
+
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    const auto nps = elapsed.count() > 0.0 ? static_cast<perft::node_count>(nodes / elapsed.count()) : nodes;
+
+    std::println("Depth: {}", depth);
+    std::println("Nodes: {}", nodes);
+    std::println("Time:  {:.3f} s", elapsed.count());
+    std::println("NPS:   {}", nps);
+
+    if (opts.hash_mb != 0) {
+        const auto hit_rate = result.table_probes > 0 ? 100.0 * result.table_hits / result.table_probes : 0.0;
+        std::println("Hash:  {} hits / {} probes ({:.1f}%)", result.table_hits, result.table_probes, hit_rate);
+    }
+}
@@ -11,6 +11,9 @@
 
 namespace {
 
+// Light and dark squares, kept here so common/config.hpp stays free of SFML
+constexpr std::array<sf::Color, 2> tile_colors{sf::Color{240, 217, 181}, sf::Color{181, 136, 99}};
+
 size_t texture_index(chessfml::piece_t::type_t type, chessfml::piece_t::color_t c)
 {
     const size_t color_offset = c == chessfml::piece_t::color_t::White ? 6 : 0;
@@ -72,7 +75,7 @@ void board_renderer::init_board()
             auto& tile = m_drawing_board[y * 8 + x];
             tile.setPosition({x_pos, y_pos});
             tile.setSize({board::tile_size_ui, board::tile_size_ui});
-            tile.setFillColor(board::tile_colors[(x + y) % 2]);
+            tile.setFillColor(tile_colors[(x + y) % 2]);
         }
     }
 }
@@ -86,7 +89,8 @@ void board_renderer::draw_board()
 
 void board_renderer::draw_pieces(const board_t& board)
 {
-    for (const auto& piece : board) {
+    for (move_t pos = 0; pos < config::board::size * config::board::size; ++pos) {
+        const auto& piece = board[pos];
         if (piece.get_type() == piece_t::type_t::Empty) {
             continue;
         }
@@ -107,7 +111,7 @@ void board_renderer::draw_pieces(const board_t& board)
         const float scaled_height = texture_height * scale_factor;
 
         // Get the top-left corner of the tile
-        sf::Vector2f tile_pos = tile_to_position(piece.get_pos());
+        sf::Vector2f tile_pos = tile_to_position(pos);
 
         // Calculate offsets to center the piece in the tile
         const float x_offset = (config::board::tile_size_ui - scaled_width) / 2.0f;
@@ -117,7 +121,7 @@ void board_renderer::draw_pieces(const board_t& board)
         sprite.setPosition({tile_pos.x + x_offset, tile_pos.y + y_offset});
 
         // Glow if selected
-        if (piece.get_pos() == m_selected_tile) {
+        if (pos == m_selected_tile) {
             sf::Sprite glow_sprite = sprite;
             create_glow_effect(glow_sprite);
         }